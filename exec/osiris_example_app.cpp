@@ -11,6 +11,7 @@
 #include <iomanip>
 #include <ios>
 #include <iostream>
+#include <vector>
 
 // this file is a loose collection of examples of things you can do with this
 // library
@@ -60,6 +61,14 @@ void print_potential_vals() {
   out_wlh << "\n";
   out_kd << "\n";
 
+  // bind each isotope once, so the energy loop skips the A-dependent terms
+  auto wlh_bound = std::vector<WLH21Params<n>::Bound>{};
+  auto kd_bound = std::vector<KD03Params<n>::Bound>{};
+  for (const auto &[Z, A] : isotopes) {
+    wlh_bound.push_back(wlh_mean.bind(Z, A));
+    kd_bound.push_back(kdn_uq.bind(Z, A));
+  }
+
   for (int j = 0; j < e_grid_sz; ++j) {
 
     const auto erg = e_grid[j];
@@ -67,12 +76,10 @@ void print_potential_vals() {
     out_kd << std::scientific << std::setprecision(5) << erg << "\t";
 
     for (int i = 0; i < niso; ++i) {
-      const auto &[Z, A] = isotopes[i];
-
       out_wlh << std::scientific << std::setprecision(5)
-              << wlh_mean.cmpl_surf_V(Z, A, erg) << "\t";
+              << wlh_bound[i].cmpl_surf_V(erg) << "\t";
       out_kd << std::scientific << std::setprecision(5)
-             << kdn_uq.cmpl_surf_V(Z, A, erg) << "\t";
+             << kd_bound[i].cmpl_surf_V(erg) << "\t";
     }
     out_wlh << "\n";
     out_kd << "\n";
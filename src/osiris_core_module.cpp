@@ -5,6 +5,7 @@
 
 #include "potential/wlh_params.hpp"
 #include "pybind11/pybind11.h"
+#include "pybind11/stl.h"
 #include "xtensor/xarray.hpp"
 #include "xtensor/xmath.hpp"
 
@@ -13,9 +14,12 @@
 
 #define FORCE_IMPORT_ARRAY
 #include "xtensor-python/pyarray.hpp"
+#include "xtensor-python/pytensor.hpp"
 #include "xtensor-python/pyvectorize.hpp"
 
+#include "potential/ensemble.hpp"
 #include "potential/potential.hpp"
+#include "potential/sample_store.hpp"
 #include "rbm/bsp.hpp"
 #include "solver/scatter.hpp"
 
@@ -38,6 +42,42 @@ template <Proj p> auto kduq_n_from_json(std::string fpath) {
   return osiris::KD03Params<p>(j);
 }
 
+template <Proj p> void declare_ch89_params(py::module &m, const char *name) {
+  using Class = CH89Params<p>;
+  py::class_<Class>(m, name)
+      .def(py::init<>())
+      .def("build_CHUQ", &Class::build_CHUQ)
+      .def("real_cent_r", &Class::real_cent_r)
+      .def("cmpl_cent_r", &Class::cmpl_cent_r)
+      .def("cmpl_surf_r", &Class::cmpl_surf_r)
+      .def("real_spin_r", &Class::real_spin_r)
+      .def("cmpl_spin_r", &Class::cmpl_spin_r)
+      .def("real_cent_a", &Class::real_cent_a)
+      .def("cmpl_cent_a", &Class::cmpl_cent_a)
+      .def("cmpl_surf_a", &Class::cmpl_surf_a)
+      .def("real_spin_a", &Class::real_spin_a)
+      .def("cmpl_spin_a", &Class::cmpl_spin_a)
+      .def("real_cent_V", &Class::real_cent_V)
+      .def("cmpl_cent_V", &Class::cmpl_cent_V)
+      .def("cmpl_surf_V", &Class::cmpl_surf_V)
+      .def("real_spin_V", &Class::real_spin_V)
+      .def("cmpl_spin_V", &Class::cmpl_spin_V);
+}
+
+/// @brief binds an ensemble constructed from a SampleStore, whose terms are
+/// returned as an 18 x len() array, one column per sample
+template <class Ensemble>
+void declare_ensemble(py::module &m, const char *name) {
+  py::class_<Ensemble>(m, name)
+      .def(py::init<const SampleStore &>())
+      .def("__len__", &Ensemble::size)
+      .def("terms", [](const Ensemble &self, Isotope iso, real erg_cms) {
+        auto t = xt::pytensor<real, 2>::from_shape({18, self.size()});
+        self.evaluate(iso, erg_cms, t.data(), self.size());
+        return t;
+      });
+}
+
 template <typename T>
 void declare_bsp_tree(py::module &m, std::string &&typestr) {
   using Class = BinarySPTree<T, xt::pyarray<real>>;
@@ -70,6 +110,11 @@ PYBIND11_MODULE(osiris_core, m) {
            Isotope
            KD03ParamsNeutron
            KD03ParamsProton
+           CH89ParamsNeutron
+           CH89ParamsProton
+           SampleStore
+           KD03Ensemble
+           CH89Ensemble
            BinarySPTree
     )pbdoc";
 
@@ -320,6 +365,34 @@ PYBIND11_MODULE(osiris_core, m) {
       .def_readwrite("aso_0", &WLH21Params<Proj::proton>::aso_0)
       .def_readwrite("aso_1", &WLH21Params<Proj::proton>::aso_1);
 
+  declare_ch89_params<Proj::neutron>(m, "CH89ParamsNeutron");
+  declare_ch89_params<Proj::proton>(m, "CH89ParamsProton");
+
+  py::class_<SampleStore>(m, "SampleStore")
+      .def(py::init<std::string>())
+      .def_static("convert", &SampleStore::convert)
+      .def("__len__", &SampleStore::size)
+      .def("names", &SampleStore::names)
+      .def("kd03_neutron", &SampleStore::sample<KD03Params<Proj::neutron>>)
+      .def("kd03_proton", &SampleStore::sample<KD03Params<Proj::proton>>)
+      .def("wlh21_neutron", &SampleStore::sample<WLH21Params<Proj::neutron>>)
+      .def("wlh21_proton", &SampleStore::sample<WLH21Params<Proj::proton>>)
+      .def("ch89_neutron", &SampleStore::sample<CH89Params<Proj::neutron>>)
+      .def("ch89_proton", &SampleStore::sample<CH89Params<Proj::proton>>)
+      // read-only numpy view of a column; keeps the store (and its mapping)
+      // alive for as long as the view
+      .def("column", [](py::object self, const std::string &field) {
+        const auto &store = self.cast<const SampleStore &>();
+        auto column = py::array_t<real>({store.size()}, {sizeof(real)},
+                                        store.column(field), self);
+        py::detail::array_proxy(column.ptr())->flags &=
+            ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+        return column;
+      });
+
+  declare_ensemble<KD03Ensemble>(m, "KD03Ensemble");
+  declare_ensemble<CH89Ensemble>(m, "CH89Ensemble");
+
   declare_bsp_tree<int>(m, std::string{"int"});
 
 #ifdef VERSION_INFO
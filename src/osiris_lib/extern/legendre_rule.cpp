@@ -1,4 +1,7 @@
 #include "extern/legendre_rule.hpp"
+#ifdef OSIRIS_GL_TABLES
+#include "extern/gl_tables.hpp"
+#endif
 
 #include <cmath>
 #include <cstdlib>
@@ -7,6 +10,10 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
 
 using namespace std;
 
@@ -28,11 +35,151 @@ void scqf(int nt, double t[], int mlt[], double wts[], int nwts, int ndx[],
 void sgqf(int nt, double aj[], double bj[], double zemu, double t[],
           double wts[]);
 
+namespace {
+
+constexpr double pi = 3.141592653589793238462643383279502884;
+
+/// @brief P_n(x) and P'_n(x) by the three-term recurrence, O(n)
+void legendre_recurrence(int n, double x, double &p, double &dp) {
+  double p0 = 1;
+  double p1 = x;
+  for (int k = 2; k <= n; ++k) {
+    const double p2 = ((2 * k - 1) * x * p1 - (k - 1) * p0) / k;
+    p0 = p1;
+    p1 = p2;
+  }
+  p = n == 0 ? 1. : p1;
+  dp = n * (x * p1 - p0) / (x * x - 1);
+}
+
+/// @returns true once a Newton step in theta is within a few ulps of theta,
+/// or has stopped decreasing, i.e. the iteration has hit the rounding level
+bool converged(double dtheta, double last, double theta) {
+  const double step = fabs(dtheta);
+  return step <= 4 * numeric_limits<double>::epsilon() * theta or
+         step >= last;
+}
+
+/// @brief Newton iteration in theta, x = cos(theta), on the recurrence, from
+/// Tricomi's initial guess for the k-th root (k = 1..n, descending in x).
+/// Working in theta keeps full relative precision in 1 - x near the endpoint
+/// @returns theta at the root, with dp = d/dtheta P_n(cos(theta)) there
+double newton_recurrence(int n, int k, double &dp) {
+  const double theta0 = pi * (4 * k - 1) / (4 * n + 2);
+  const double s0 = sin(theta0);
+  const double nn = n;
+  double theta = acos((1 - (nn - 1) / (8 * nn * nn * nn) -
+                       (39 - 28 / (s0 * s0)) / (384 * nn * nn * nn * nn)) *
+                      cos(theta0));
+  double p;
+  double last = HUGE_VAL;
+  for (int iter = 0; iter < 100; ++iter) {
+    legendre_recurrence(n, cos(theta), p, dp);
+    const double dtheta = p / (-sin(theta) * dp);
+    theta -= dtheta;
+    if (converged(dtheta, last, theta))
+      break;
+    last = fabs(dtheta);
+  }
+  legendre_recurrence(n, cos(theta), p, dp);
+  dp *= -sin(theta);
+  return theta;
+}
+
+/// @brief P_n(cos(theta)) and d/dtheta P_n(cos(theta)) from the Stieltjes
+/// asymptotic expansion, O(1) in n:
+/// P_n(cos t) = C_n sum_m h_m cos(a_m) / (2 sin t)^(m + 1/2),
+/// a_m = (n + m + 1/2) t - (m + 1/2) pi/2,
+/// h_0 = 1, h_m = h_(m-1) (m - 1/2)^2 / (m (n + m + 1/2))
+/// @returns false if the series did not converge, i.e. theta is too close to
+/// an endpoint
+bool legendre_stieltjes(int n, double cn, double theta, double &p,
+                        double &dp) {
+  constexpr int max_terms = 30;
+  const double s = sin(theta);
+  const double c = cos(theta);
+  const double two_s = 2 * s;
+  double h = 1;
+  double scale = 1 / sqrt(two_s);
+  const double leading = scale;
+  p = 0;
+  dp = 0;
+  for (int m = 0; m < max_terms; ++m) {
+    const double mh = m + 0.5;
+    const double alpha = (n + mh) * theta - mh * pi / 2;
+    const double term = h * scale * cos(alpha);
+    p += term;
+    dp += -h * scale * ((n + mh) * sin(alpha) + mh * cos(alpha) * c / s);
+    if (h * scale < 1e-17 * leading) {
+      p *= cn;
+      dp *= cn;
+      return true;
+    }
+    h *= (m + 0.5) * (m + 0.5) / ((m + 1) * (n + m + 1.5));
+    scale /= two_s;
+  }
+  return false;
+}
+
+/// @brief Newton iteration in theta on the Stieltjes expansion, from theta
+/// @returns false if the expansion failed to converge at any iterate, in
+/// which case theta and dp are not to be used; otherwise theta at the root,
+/// with dp = d/dtheta P_n(cos(theta)) there
+bool newton_stieltjes(int n, double cn, double &theta, double &dp) {
+  double p = 0;
+  double last = HUGE_VAL;
+  for (int iter = 0; iter < 20; ++iter) {
+    if (not legendre_stieltjes(n, cn, theta, p, dp))
+      return false;
+    const double dtheta = p / dp;
+    theta -= dtheta;
+    if (converged(dtheta, last, theta))
+      break;
+    last = fabs(dtheta);
+  }
+  return legendre_stieltjes(n, cn, theta, p, dp);
+}
+
+} // namespace
+
 std::vector<gl::zero_crossing>
 gl::generate_gauss_legendre_quadrature(int order) {
-  auto x = new double[order];
-  auto w = new double[order];
-  cdgqf(order, 1, 1, 1, x, w);
+  const int n = order;
+  std::vector<gl::zero_crossing> quadrature(n);
+
+  // C_n = (4/pi) prod_j j/(j + 1/2), for the asymptotic expansion
+  double cn = 4 / pi;
+  if (n > 100)
+    for (int j = 1; j <= n; ++j)
+      cn *= j / (j + 0.5);
+
+  // roots are symmetric about 0: find x_k > 0 for k = 1..ceil(n/2) and mirror
+  for (int k = 1; k <= (n + 1) / 2; ++k) {
+    double theta = pi * (4 * k - 1) / (4 * n + 2);
+    double dp = 1;
+    // the expansion converges when n sin(theta) is large; near the endpoints,
+    // or wherever it fails to converge, fall back to the recurrence
+    const bool asymptotic = n > 100 and n * sin(theta) > 25 and
+                            newton_stieltjes(n, cn, theta, dp);
+    if (not asymptotic)
+      theta = newton_recurrence(n, k, dp);
+    // (1 - x^2) P'_n(x)^2 = (d/dtheta P_n)^2
+    const double weight = 2 / (dp * dp);
+    // map to [0, 1] in ascending order: (1 -+ cos(theta))/2
+    const double lower = sin(0.5 * theta) * sin(0.5 * theta);
+    const double upper = cos(0.5 * theta) * cos(0.5 * theta);
+    quadrature[n - k] = {upper, 0.5 * weight};
+    quadrature[k - 1] = {lower, 0.5 * weight};
+  }
+  if (n % 2 == 1)
+    quadrature[n / 2].abscissa = 0.5;
+  return quadrature;
+}
+
+std::vector<gl::zero_crossing> gl::golub_welsch_quadrature(int order) {
+  auto x = std::vector<double>(order);
+  auto w = std::vector<double>(order);
+  cdgqf(order, 1, 1, 1, x.data(), w.data());
   std::vector<gl::zero_crossing> quadrature(order);
   for (int i = 0; i < order; ++i) {
     quadrature[i] = {0.5 * (x[i] + 1), 0.5 * w[i]};
@@ -40,6 +187,28 @@ gl::generate_gauss_legendre_quadrature(int order) {
   return quadrature;
 }
 
+const std::vector<gl::zero_crossing> &
+gl::gauss_legendre_quadrature(int order) {
+  static std::shared_mutex mutex;
+  static std::map<int, const std::vector<gl::zero_crossing>> rules;
+  {
+    std::shared_lock lock(mutex);
+    const auto it = rules.find(order);
+    if (it != rules.end())
+      return it->second;
+  }
+#ifdef OSIRIS_GL_TABLES
+  // deployed mesh sizes are tabulated at build time
+  const auto *nodes = tabulated_rule(order);
+  auto rule = nodes ? std::vector<gl::zero_crossing>(nodes, nodes + order)
+                    : generate_gauss_legendre_quadrature(order);
+#else
+  auto rule = generate_gauss_legendre_quadrature(order);
+#endif
+  std::unique_lock lock(mutex);
+  return rules.try_emplace(order, std::move(rule)).first->second;
+}
+
 //****************************************************************************80
 
 void cdgqf(int nt, int kind, double alpha, double beta, double t[],
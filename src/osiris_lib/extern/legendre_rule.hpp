@@ -1,3 +1,6 @@
+#ifndef LEGENDRE_RULE_HEADER
+#define LEGENDRE_RULE_HEADER
+
 #include "util/types.hpp"
 
 #include <vector>
@@ -9,6 +12,25 @@ struct zero_crossing {
   osiris::real weight;
 };
 
+/// @returns the Gauss-Legendre rule of a given order on [0,1], abscissas in
+/// ascending order and weights summing to 1. Roots are found by Newton
+/// iteration: on the three-term recurrence from Tricomi's initial guess for
+/// order <= 100, and on the Stieltjes asymptotic expansion of P_n for interior
+/// roots of higher orders, which costs O(1) per root, as in
+/// Hale, N., and A. Townsend.
+/// "Fast and accurate computation of Gauss-Legendre and Gauss-Jacobi
+/// quadrature nodes and weights." SIAM J. Sci. Comput. 35.2 (2013): A652-A674.
 std::vector<zero_crossing> generate_gauss_legendre_quadrature(int order);
 
+/// @returns the same rule by the Golub-Welsch eigenvalue method (IQPACK)
+std::vector<zero_crossing> golub_welsch_quadrature(int order);
+
+/// @returns the rule of a given order from a process-wide, thread-safe cache,
+/// generating it on first use, or copying it from gl_tables.hpp if the order
+/// was tabulated at build time. The reference stays valid for the lifetime of
+/// the program
+const std::vector<zero_crossing> &gauss_legendre_quadrature(int order);
+
 } // namespace gl
+
+#endif
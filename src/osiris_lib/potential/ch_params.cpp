@@ -22,6 +22,11 @@ CH89Params<Proj::proton>::CH89Params(json p)
     : CH89Params<Proj::neutron>(p), OMParams<Proj::proton>(),
       rc_0(p["CH89Coulomb"]["r_c_0"]), rc_A(p["CH89Coulomb"]["r_c"]) {}
 
+CH89Params<Proj::proton>::CH89Params(const SampleStore &store, size_t sample)
+    : CH89Params<Proj::neutron>(store, sample), OMParams<Proj::proton>(),
+      rc_0(store.row(sample)["CH89Coulomb"]["r_c_0"]),
+      rc_A(store.row(sample)["CH89Coulomb"]["r_c"]) {}
+
 real osiris::CH89Params<Proj::proton>::Ec(int Z, int A, real erg) const {
   const real z = static_cast<real>(Z);
 
@@ -32,3 +37,11 @@ real osiris::CH89Params<Proj::proton>::real_coul_r(int, int A, real) const {
   const real a = static_cast<real>(A);
   return rc_0 + rc_A * pow(a, 1. / 3.);
 }
+
+CH89Params<Proj::proton>::Bound
+osiris::CH89Params<Proj::proton>::bind(int Z, int A) const {
+  const real a = static_cast<real>(A);
+  return {{CH89Params<Proj::neutron>::bind(Z, A)},
+          real_coul_V_outer(Z, A, 0),
+          real_coul_r(Z, A, 0) * pow(a, 1. / 3.)};
+}
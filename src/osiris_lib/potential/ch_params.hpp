@@ -2,15 +2,20 @@
 #define CH_PARAMS_HEADER
 
 #include "potential/params_base.hpp"
+#include "potential/sample_store.hpp"
 #include "util/types.hpp"
 
 namespace osiris {
 
+class CH89Ensemble;
+
 /// @brief  Phenomenological global OM potential parameterization from:
 /// R. Varner, W. Thompson, T. McAbee, E. Ludwig, and T. Clegg,
 /// Physics Reports 201, 57 (1991), ISSN 0370-1573,
 /// URL https://www.sciencedirect.com/science/article/pii/037015739190039O
 template <Proj projectile> class CH89Params : public OMParams<projectile> {
+  friend class CH89Ensemble;
+
 protected:
   // real central shape
   real r_0, r_A;
@@ -70,21 +75,12 @@ public:
   // construct using default CH89 params
   CH89Params();
 
-  CH89Params(json p)
-      : r_0(p["CH89RealCentral"]["r_o_0"]), r_A(p["CH89RealCentral"]["r_o"]),
-        a0(p["CH89RealCentral"]["a_0"]), rw_0(p["CH89ImagCentral"]["r_w0"]),
-        rw_A(p["CH89ImagCentral"]["r_w"]), aw(p["CH89ImagCentral"]["a_w"]),
-        rso_0(p["CH89SpinOrbit"]["r_so_0"]), rso_A(p["CH89SpinOrbit"]["r_so"]),
-        aso(p["CH89SpinOrbit"]["a_so"]),
-
-        v_0(p["CH89RealCentral"]["V_0"]), v_e(p["CH89RealCentral"]["V_e"]),
-        v_asym(p["CH89RealCentral"]["V_t"]), wv_0(p["CH89ImagCentral"]["W_v0"]),
-        wve_0(p["CH89ImagCentral"]["W_ve0"]), wv_ew(p["CH89ImagCentral"]["W_vew"]),
-        ws_0(p["CH89ImagCentral"]["W_s0"]), ws_asym(p["CH89ImagCentral"]["W_st"]),
-        ws_e0(p["CH89ImagCentral"]["W_se0"]), ws_ew(p["CH89ImagCentral"]["W_sew"]),
-        vso_0(p["CH89SpinOrbit"]["V_so"])
-
-  {}
+  CH89Params(json p) { read(p); }
+  /// @brief construct from a sample of a store in the JSON layout, reading
+  /// its columns directly
+  CH89Params(const SampleStore &store, size_t sample) {
+    read(store.row(sample));
+  }
 
   /// @brief constructs a CH89Params\<p\> with params refit w/ MCMC; from
   /// Pruitt, C. D. et al,
@@ -122,11 +118,103 @@ public:
 
     return p;
   };
+
+  /// @brief CH89 bound to a single target. The A- and Z-dependent factors,
+  /// A^(1/3) and the asymmetry, are computed once by bind, so each energy only
+  /// costs the energy polynomials and exponentials. Accessors take the energy
+  /// alone and return exactly what the accessors of the parameters it was
+  /// bound from return for that target. Holds a pointer to those parameters,
+  /// which must outlive it
+  class Bound {
+  private:
+    friend class CH89Params<projectile>;
+
+    const CH89Params<projectile> *p;
+    real Ec;
+    real rv, rw, rso;
+    real v_asym, ws;
+
+  public:
+    static constexpr bool charged = false;
+
+    real real_cent_r(real) const { return rv; }
+    real cmpl_cent_r(real) const { return rw; }
+    real real_surf_r(real) const { return 0; }
+    real cmpl_surf_r(real) const { return rw; }
+    real real_spin_r(real) const { return rso; }
+    real cmpl_spin_r(real) const { return 0; }
+
+    real real_cent_a(real) const { return p->a0; }
+    real cmpl_cent_a(real) const { return p->aw; }
+    real real_surf_a(real) const { return 0; }
+    real cmpl_surf_a(real) const { return p->aw; }
+    real real_spin_a(real) const { return p->aso; }
+    real cmpl_spin_a(real) const { return 0; }
+
+    real real_cent_V(real erg) const {
+      const real dE = erg - Ec;
+      return -(p->v_0 + p->v_e * dE + v_asym);
+    }
+    real cmpl_cent_V(real erg) const {
+      const real dE = erg - Ec;
+      return -p->wv_0 / (1 + exp((p->wve_0 - dE) / p->wv_ew));
+    }
+    real real_surf_V(real) const { return 0; }
+    real cmpl_surf_V(real erg) const {
+      const real dE = erg - Ec;
+      const real Ws = ws / (1 + exp((dE - p->ws_e0) / p->ws_ew));
+      return 4 * p->aw * Ws;
+    }
+    real real_spin_V(real) const { return 2. * p->vso_0; }
+    real cmpl_spin_V(real) const { return 0; }
+  };
+
+  /// @returns these parameters bound to the target Z, A
+  Bound bind(int Z, int A) const {
+    const real a3 = pow(static_cast<real>(A), 1. / 3.);
+    auto b = Bound{};
+    b.p = this;
+    // Ec does not depend on the energy
+    b.Ec = Ec(Z, A, 0);
+    b.rv = r_0 + r_A * a3;
+    b.rw = rw_0 + rw_A * a3;
+    b.rso = rso_0 + rso_A * a3;
+    b.v_asym = asym(Z, A) * v_asym;
+    b.ws = ws_0 + asym(Z, A) * ws_asym;
+    return b;
+  }
+
+private:
+  /// @brief reads the parameters from p["group"]["key"], p being a JSON
+  /// object or a SampleStore::Row
+  template <class Sample> void read(Sample &&p) {
+    r_0 = p["CH89RealCentral"]["r_o_0"];
+    r_A = p["CH89RealCentral"]["r_o"];
+    a0 = p["CH89RealCentral"]["a_0"];
+    rw_0 = p["CH89ImagCentral"]["r_w0"];
+    rw_A = p["CH89ImagCentral"]["r_w"];
+    aw = p["CH89ImagCentral"]["a_w"];
+    rso_0 = p["CH89SpinOrbit"]["r_so_0"];
+    rso_A = p["CH89SpinOrbit"]["r_so"];
+    aso = p["CH89SpinOrbit"]["a_so"];
+
+    v_0 = p["CH89RealCentral"]["V_0"];
+    v_e = p["CH89RealCentral"]["V_e"];
+    v_asym = p["CH89RealCentral"]["V_t"];
+    wv_0 = p["CH89ImagCentral"]["W_v0"];
+    wve_0 = p["CH89ImagCentral"]["W_ve0"];
+    wv_ew = p["CH89ImagCentral"]["W_vew"];
+    ws_0 = p["CH89ImagCentral"]["W_s0"];
+    ws_asym = p["CH89ImagCentral"]["W_st"];
+    ws_e0 = p["CH89ImagCentral"]["W_se0"];
+    ws_ew = p["CH89ImagCentral"]["W_sew"];
+    vso_0 = p["CH89SpinOrbit"]["V_so"];
+  }
 };
 
 template <>
 class CH89Params<Proj::proton> : public CH89Params<Proj::neutron>,
-                                 OMParams<Proj::proton> {
+                                 public OMParams<Proj::proton> {
 protected:
   real rc_0, rc_A;
   real Ec(int Z, int A, real erg) const;
@@ -138,6 +226,20 @@ public:
   CH89Params(const CH89Params<Proj::proton> &rhs) = default;
   CH89Params();
   CH89Params(json p);
+  CH89Params(const SampleStore &store, size_t sample);
+
+  /// @brief CH89Params<Proj::neutron>::Bound plus the energy-independent
+  /// Coulomb term of get_coulomb_term
+  struct Bound : CH89Params<Proj::neutron>::Bound {
+    static constexpr bool charged = true;
+    /// @brief Z e^2 [MeV fm]
+    real coul_q2;
+    /// @brief radius of the uniformly charged sphere [fm]
+    real coul_R;
+  };
+
+  /// @returns these parameters bound to the target Z, A
+  Bound bind(int Z, int A) const;
 };
 
 template <Proj proj>
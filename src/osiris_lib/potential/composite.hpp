@@ -0,0 +1,206 @@
+#ifndef COMPOSITE_HEADER
+#define COMPOSITE_HEADER
+
+#include "potential/potential.hpp"
+#include "util/types.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <type_traits>
+
+namespace osiris {
+
+/// @brief Compile-time composition of local potential forms. Each leaf reads
+/// its parameters from a fixed offset of a flat parameter array, and terms
+/// combine with + and scalar *, e.g.
+///   const auto expr = terms::WoodsSaxon<0>{} +
+///                     constants::i * terms::DerivWoodsSaxon<3>{} +
+///                     l_dot_s * terms::Thomas<6>{} + terms::Coulomb<9>{};
+///   const auto v = compose<xt::xtensor<real, 1>>(expr);
+/// Binding an expression to a parameter array reads every parameter once, and
+/// the bound expression is a plain value whose evaluation inlines to a single
+/// function of r, so Composite::batch is one fused loop over the mesh
+namespace terms {
+
+/// @brief tag base of all terms
+struct Term {};
+
+template <class E>
+constexpr bool is_term_v = std::is_base_of_v<Term, std::decay_t<E>>;
+
+/// @brief V / (1 + exp((r - R) / a)); V, R, a at params(Offset...)
+template <size_t Offset> struct WoodsSaxon : Term {
+  static constexpr size_t arity = Offset + 3;
+
+  struct Bound {
+    real V, R, a;
+    real operator()(real r) const {
+      return fabs(a) < 1e-12 ? 0. : detail::woods_saxon(r, V, R, a);
+    }
+  };
+
+  template <class T> Bound bind(const T &params) const {
+    return {params(Offset), params(Offset + 1), params(Offset + 2)};
+  }
+};
+
+/// @brief d/dr of WoodsSaxon; V, R, a at params(Offset...)
+template <size_t Offset> struct DerivWoodsSaxon : Term {
+  static constexpr size_t arity = Offset + 3;
+
+  struct Bound {
+    real V, R, a;
+    real operator()(real r) const {
+      return fabs(a) < 1e-12 ? 0. : detail::deriv_woods_saxon(r, V, R, a);
+    }
+  };
+
+  template <class T> Bound bind(const T &params) const {
+    return {params(Offset), params(Offset + 1), params(Offset + 2)};
+  }
+};
+
+/// @brief d/dr of WoodsSaxon times 1/r; V, R, a at params(Offset...)
+template <size_t Offset> struct Thomas : Term {
+  static constexpr size_t arity = Offset + 3;
+
+  struct Bound {
+    real V, R, a;
+    real operator()(real r) const {
+      return fabs(a) < 1e-12 ? 0. : detail::deriv_woods_saxon(r, V, R, a) / r;
+    }
+  };
+
+  template <class T> Bound bind(const T &params) const {
+    return {params(Offset), params(Offset + 1), params(Offset + 2)};
+  }
+};
+
+/// @brief -force_coupling exp(-r / mass_coupling) / r; mass_coupling and
+/// force_coupling at params(Offset...)
+template <size_t Offset> struct Yukawa : Term {
+  static constexpr size_t arity = Offset + 2;
+
+  struct Bound {
+    real mass_coupling, force_coupling;
+    real operator()(real r) const {
+      return -force_coupling * exp(-r / mass_coupling) / r;
+    }
+  };
+
+  template <class T> Bound bind(const T &params) const {
+    return {params(Offset), params(Offset + 1)};
+  }
+};
+
+/// @brief uniformly charged sphere; q2 = Z z e^2 [MeV fm] and Rc [fm] at
+/// params(Offset...)
+template <size_t Offset> struct Coulomb : Term {
+  static constexpr size_t arity = Offset + 2;
+
+  struct Bound {
+    real q2, Rc;
+    real operator()(real r) const {
+      return detail::uniform_sphere_coulomb(r, q2, Rc);
+    }
+  };
+
+  template <class T> Bound bind(const T &params) const {
+    return {params(Offset), params(Offset + 1)};
+  }
+};
+
+/// @brief A + B
+template <class A, class B> struct Sum : Term {
+  static constexpr size_t arity = std::max(A::arity, B::arity);
+  A a;
+  B b;
+
+  Sum(A a, B b) : a(a), b(b) {}
+
+  struct Bound {
+    typename A::Bound a;
+    typename B::Bound b;
+    auto operator()(real r) const { return a(r) + b(r); }
+  };
+
+  template <class T> Bound bind(const T &params) const {
+    return {a.bind(params), b.bind(params)};
+  }
+};
+
+/// @brief factor * E, for a factor known at run time, e.g. i or L * S
+template <class E> struct Scaled : Term {
+  static constexpr size_t arity = E::arity;
+  cmpl factor;
+  E e;
+
+  Scaled(cmpl factor, E e) : factor(factor), e(e) {}
+
+  struct Bound {
+    cmpl factor;
+    typename E::Bound e;
+    cmpl operator()(real r) const { return factor * e(r); }
+  };
+
+  template <class T> Bound bind(const T &params) const {
+    return {factor, e.bind(params)};
+  }
+};
+
+template <class A, class B,
+          typename std::enable_if_t<is_term_v<A> and is_term_v<B>, bool> = true>
+Sum<A, B> operator+(A a, B b) {
+  return {a, b};
+}
+
+template <class E, typename std::enable_if_t<is_term_v<E>, bool> = true>
+Scaled<E> operator*(cmpl factor, E e) {
+  return {factor, e};
+}
+
+template <class E, typename std::enable_if_t<is_term_v<E>, bool> = true>
+Scaled<E> operator*(real factor, E e) {
+  return {factor, e};
+}
+
+} // namespace terms
+
+/// @brief Adapts a terms:: expression to the Potential<T> interface. Both
+/// operator() and batch bind the expression to the parameters once; batch
+/// then evaluates it in a single loop over the radii
+template <class T, class Expr> struct Composite : public Potential<T> {
+  Expr expr;
+
+  explicit Composite(Expr expr) : expr(expr) {}
+
+  /// @brief number of parameters read by the expression
+  static constexpr size_t arity = Expr::arity;
+
+  cmpl operator()(real r, T params) const final {
+    assert(params.size() >= arity);
+    return expr.bind(params)(r);
+  }
+
+  void batch(const real *r, size_t n, const T &params,
+             cmpl *out) const final {
+    assert(params.size() >= arity);
+    const auto bound = expr.bind(params);
+    for (size_t i = 0; i < n; ++i)
+      out[i] = bound(r[i]);
+  }
+};
+
+/// @returns expr as a Potential<T>
+template <class T, class Expr,
+          typename std::enable_if_t<terms::is_term_v<Expr>, bool> = true>
+Composite<T, Expr> compose(Expr expr) {
+  return Composite<T, Expr>(expr);
+}
+
+} // namespace osiris
+
+#endif
@@ -0,0 +1,217 @@
+#include "potential/ensemble.hpp"
+#include "util/constants.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace osiris;
+
+namespace {
+
+std::vector<real> read_column(const SampleStore &store,
+                              const std::string &field) {
+  const real *column = store.column(field);
+  return std::vector<real>(column, column + store.size());
+}
+
+} // namespace
+
+osiris::KD03Ensemble::KD03Ensemble(const SampleStore &store) {
+  const auto read = [&store](const std::string &field) {
+    return read_column(store, field);
+  };
+  // KD03Params(json) takes the neutron-specific fields, also for protons, and
+  // the neutron Fermi energy unless the sample has a KDFermi group
+  const auto defaults = Params();
+  const auto read_or = [&](const std::string &field, real fallback) {
+    const auto &names = store.names();
+    if (std::find(names.begin(), names.end(), field) == names.end())
+      return std::vector<real>(store.size(), fallback);
+    return read(field);
+  };
+  e_fermi_0 = read_or("/KDFermi/E_f_0", defaults.e_fermi_0);
+  e_fermi_A = read_or("/KDFermi/E_f_A", defaults.e_fermi_A);
+  rv_0 = read("/KDHartreeFock/r_0");
+  rv_A = read("/KDHartreeFock/r_A");
+  av_0 = read("/KDHartreeFock/a_0");
+  av_A = read("/KDHartreeFock/a_A");
+  rd_0 = read("/KDImagSurface/r_0");
+  rd_A = read("/KDImagSurface/r_A");
+  ad_0 = read("/KDImagSurface/a_0_n");
+  ad_A = read("/KDImagSurface/a_A_n");
+  rso_0 = read("/KDRealSpinOrbit/r_0");
+  rso_A = read("/KDRealSpinOrbit/r_A");
+  aso_0 = read("/KDRealSpinOrbit/a_0");
+  v1_0 = read("/KDHartreeFock/V1_0");
+  v1_asym = read("/KDHartreeFock/V1_asymm");
+  v1_A = read("/KDHartreeFock/V1_A");
+  v2_0 = read("/KDHartreeFock/V2_0_n");
+  v2_A = read("/KDHartreeFock/V2_A_n");
+  v3_0 = read("/KDHartreeFock/V3_0_n");
+  v3_A = read("/KDHartreeFock/V3_A_n");
+  v4_0 = read("/KDHartreeFock/V4_0");
+  w1_0 = read("/KDImagVolume/W1_0_n");
+  w1_A = read("/KDImagVolume/W1_A_n");
+  w2_0 = read("/KDImagVolume/W2_0");
+  w2_A = read("/KDImagVolume/W2_A");
+  d1_0 = read("/KDImagSurface/D1_0");
+  d1_asym = read("/KDImagSurface/D1_asymm");
+  d2_0 = read("/KDImagSurface/D2_0");
+  d2_A = read("/KDImagSurface/D2_A");
+  d2_A2 = read("/KDImagSurface/D2_A2");
+  d2_A3 = read("/KDImagSurface/D2_A3");
+  d3_0 = read("/KDImagSurface/D3_0");
+  vso1_0 = read("/KDRealSpinOrbit/V1_0");
+  vso1_A = read("/KDRealSpinOrbit/V1_A");
+  vso2_0 = read("/KDRealSpinOrbit/V2_0");
+  wso1_0 = read("/KDImagSpinOrbit/W1_0");
+  wso2_0 = read("/KDImagSpinOrbit/W2_0");
+}
+
+osiris::CH89Ensemble::CH89Ensemble(const SampleStore &store) {
+  const auto read = [&store](const std::string &field) {
+    return read_column(store, field);
+  };
+  r_0 = read("/CH89RealCentral/r_o_0");
+  r_A = read("/CH89RealCentral/r_o");
+  a0 = read("/CH89RealCentral/a_0");
+  rw_0 = read("/CH89ImagCentral/r_w0");
+  rw_A = read("/CH89ImagCentral/r_w");
+  aw = read("/CH89ImagCentral/a_w");
+  rso_0 = read("/CH89SpinOrbit/r_so_0");
+  rso_A = read("/CH89SpinOrbit/r_so");
+  aso = read("/CH89SpinOrbit/a_so");
+  v_0 = read("/CH89RealCentral/V_0");
+  v_e = read("/CH89RealCentral/V_e");
+  v_asym = read("/CH89RealCentral/V_t");
+  wv_0 = read("/CH89ImagCentral/W_v0");
+  wve_0 = read("/CH89ImagCentral/W_ve0");
+  wv_ew = read("/CH89ImagCentral/W_vew");
+  ws_0 = read("/CH89ImagCentral/W_s0");
+  ws_asym = read("/CH89ImagCentral/W_st");
+  ws_e0 = read("/CH89ImagCentral/W_se0");
+  ws_ew = read("/CH89ImagCentral/W_sew");
+  vso_0 = read("/CH89SpinOrbit/V_so");
+}
+
+void osiris::KD03Ensemble::evaluate(Isotope iso, real erg_cms, real *out,
+                                    size_t stride) const {
+  const auto n = size();
+  assert(stride >= n);
+  const real a = static_cast<real>(iso.A);
+  const real a3 = pow(a, 1. / 3.);
+  const real alpha = Params::asym(iso.Z, iso.A);
+
+  // one loop per parameter, each reading only the columns it depends on, so
+  // that the loops vectorize with few run-time alias checks
+  const auto fill = [=](size_t k, auto term) {
+    real *row = out + k * stride;
+    for (size_t s = 0; s < n; ++s)
+      row[s] = term(s);
+  };
+  const auto dE = [&](size_t s) {
+    return erg_cms - (e_fermi_0[s] + e_fermi_A[s] * a);
+  };
+  const auto rv = [&](size_t s) { return rv_0[s] * a3 - rv_A[s]; };
+  const auto av = [&](size_t s) { return av_0[s] - av_A[s] * a; };
+  const auto ad = [&](size_t s) { return ad_0[s] - ad_A[s] * a; };
+  const auto rso = [&](size_t s) { return rso_0[s] * a3 - rso_A[s]; };
+  const auto zero = [](size_t) { return 0.; };
+
+  fill(0, [&](size_t s) {
+    const real e = dE(s);
+    const real v1 = v1_0[s] - v1_A[s] * a + v1_asym[s] * alpha;
+    const real v2 = v2_0[s] - v2_A[s] * a;
+    const real v3 = v3_0[s] - v3_A[s] * a;
+    const real v4 = v4_0[s];
+    return -v1 * (1. - v2 * e + v3 * e * e - v4 * e * e * e);
+  });
+  fill(1, rv);
+  fill(2, av);
+  fill(3, [&](size_t s) {
+    const real e = dE(s);
+    const real w1 = w1_0[s] + w1_A[s] * a;
+    const real w2 = w2_0[s] + w2_A[s] * a;
+    return -w1 * e * e / (e * e + w2 * w2);
+  });
+  fill(4, rv);
+  fill(5, av);
+  fill(6, zero);
+  fill(7, zero);
+  fill(8, zero);
+  fill(10, [&](size_t s) { return rd_0[s] * a3 - rd_A[s] * a3 * a3; });
+  fill(11, ad);
+  // reads the diffuseness back from row 11, one column fewer to check
+  const real *cmpl_surf_a = out + 11 * stride;
+  fill(9, [&](size_t s) {
+    const real e = dE(s);
+    const real d1 = d1_0[s] + d1_asym[s] * alpha;
+    const real d2 = d2_0[s] + d2_A[s] / (1 + exp((a - d2_A3[s]) / d2_A2[s]));
+    const real d3 = d3_0[s];
+    return 4 * cmpl_surf_a[s] * d1 * e * e / (e * e + d3 * d3) *
+           exp(-d2 * e);
+  });
+  fill(12, [&](size_t s) {
+    const real vso1 = vso1_0[s] + vso1_A[s] * a;
+    return constants::csp * vso1 * exp(-vso2_0[s] * dE(s));
+  });
+  fill(13, rso);
+  fill(14, [&](size_t s) { return aso_0[s]; });
+  fill(15, [&](size_t s) {
+    const real e = dE(s);
+    const real wso2 = wso2_0[s];
+    return constants::csp * wso1_0[s] * e * e / (e * e + wso2 * wso2);
+  });
+  fill(16, rso);
+  fill(17, [&](size_t s) { return aso_0[s]; });
+}
+
+void osiris::CH89Ensemble::evaluate(Isotope iso, real erg_cms, real *out,
+                                    size_t stride) const {
+  const auto n = size();
+  assert(stride >= n);
+  const real a3 = pow(static_cast<real>(iso.A), 1. / 3.);
+  const real alpha = Params::asym(iso.Z, iso.A);
+  // CH89Params<Proj::neutron>::Ec is 0
+  const real dE = erg_cms;
+
+  // one loop per parameter, see KD03Ensemble::evaluate
+  const auto fill = [=](size_t k, auto term) {
+    real *row = out + k * stride;
+    for (size_t s = 0; s < n; ++s)
+      row[s] = term(s);
+  };
+  const auto rw = [&](size_t s) { return rw_0[s] + rw_A[s] * a3; };
+  const auto aw_s = [&](size_t s) { return aw[s]; };
+  const auto zero = [](size_t) { return 0.; };
+
+  fill(0, [&](size_t s) {
+    return -(v_0[s] + v_e[s] * dE + alpha * v_asym[s]);
+  });
+  fill(1, [&](size_t s) { return r_0[s] + r_A[s] * a3; });
+  fill(2, [&](size_t s) { return a0[s]; });
+  fill(3, [&](size_t s) {
+    return -wv_0[s] / (1 + exp((wve_0[s] - dE) / wv_ew[s]));
+  });
+  fill(4, rw);
+  fill(5, aw_s);
+  fill(6, zero);
+  fill(7, zero);
+  fill(8, zero);
+  fill(9, [&](size_t s) {
+    const real Ws = (ws_0[s] + alpha * ws_asym[s]) /
+                    (1 + exp((dE - ws_e0[s]) / ws_ew[s]));
+    return 4 * aw[s] * Ws;
+  });
+  fill(10, rw);
+  fill(11, aw_s);
+  fill(12, [&](size_t s) { return 2. * vso_0[s]; });
+  fill(13, [&](size_t s) { return rso_0[s] + rso_A[s] * a3; });
+  fill(14, [&](size_t s) { return aso[s]; });
+  fill(15, zero);
+  fill(16, zero);
+  fill(17, zero);
+}
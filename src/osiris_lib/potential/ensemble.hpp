@@ -0,0 +1,175 @@
+#ifndef ENSEMBLE_HEADER
+#define ENSEMBLE_HEADER
+
+#include "potential/ch_params.hpp"
+#include "potential/kd_params.hpp"
+#include "potential/sample_store.hpp"
+#include "util/nuc_data.hpp"
+#include "util/types.hpp"
+
+#include <xtensor/xtensor.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace osiris {
+
+/// @brief N samples of the KD03 parameters, e.g. draws from the KDUQ
+/// posterior, stored column-wise with one array per parameter. All samples
+/// are evaluated in a single loop per target and energy, which the compiler
+/// can vectorize, instead of 18 virtual calls per sample. Evaluates the
+/// accessors of KD03Params<Proj::neutron>, which KD03Params<Proj::proton>
+/// inherits, so ensembles of either projectile reproduce get_global_terms for
+/// each of their samples
+class KD03Ensemble {
+private:
+  using Params = KD03Params<Proj::neutron>;
+
+  std::vector<real> e_fermi_0, e_fermi_A;
+  std::vector<real> rv_0, rv_A, av_0, av_A;
+  std::vector<real> rd_0, rd_A, ad_0, ad_A;
+  std::vector<real> rso_0, rso_A, aso_0;
+  std::vector<real> v1_0, v1_asym, v1_A, v2_0, v2_A, v3_0, v3_A, v4_0;
+  std::vector<real> w1_0, w1_A, w2_0, w2_A;
+  std::vector<real> d1_0, d1_asym, d2_0, d2_A, d2_A2, d2_A3, d3_0;
+  std::vector<real> vso1_0, vso1_A, vso2_0;
+  std::vector<real> wso1_0, wso2_0;
+
+  template <class Sample>
+  static std::vector<real> gather(const std::vector<Sample> &samples,
+                                  real Params::*field) {
+    auto column = std::vector<real>(samples.size());
+    for (size_t s = 0; s < samples.size(); ++s)
+      column[s] = static_cast<const Params &>(samples[s]).*field;
+    return column;
+  }
+
+public:
+  template <Proj p>
+  explicit KD03Ensemble(const std::vector<KD03Params<p>> &samples)
+      : e_fermi_0(gather(samples, &Params::e_fermi_0)),
+        e_fermi_A(gather(samples, &Params::e_fermi_A)),
+        rv_0(gather(samples, &Params::rv_0)),
+        rv_A(gather(samples, &Params::rv_A)),
+        av_0(gather(samples, &Params::av_0)),
+        av_A(gather(samples, &Params::av_A)),
+        rd_0(gather(samples, &Params::rd_0)),
+        rd_A(gather(samples, &Params::rd_A)),
+        ad_0(gather(samples, &Params::ad_0)),
+        ad_A(gather(samples, &Params::ad_A)),
+        rso_0(gather(samples, &Params::rso_0)),
+        rso_A(gather(samples, &Params::rso_A)),
+        aso_0(gather(samples, &Params::aso_0)),
+        v1_0(gather(samples, &Params::v1_0)),
+        v1_asym(gather(samples, &Params::v1_asym)),
+        v1_A(gather(samples, &Params::v1_A)),
+        v2_0(gather(samples, &Params::v2_0)),
+        v2_A(gather(samples, &Params::v2_A)),
+        v3_0(gather(samples, &Params::v3_0)),
+        v3_A(gather(samples, &Params::v3_A)),
+        v4_0(gather(samples, &Params::v4_0)),
+        w1_0(gather(samples, &Params::w1_0)),
+        w1_A(gather(samples, &Params::w1_A)),
+        w2_0(gather(samples, &Params::w2_0)),
+        w2_A(gather(samples, &Params::w2_A)),
+        d1_0(gather(samples, &Params::d1_0)),
+        d1_asym(gather(samples, &Params::d1_asym)),
+        d2_0(gather(samples, &Params::d2_0)),
+        d2_A(gather(samples, &Params::d2_A)),
+        d2_A2(gather(samples, &Params::d2_A2)),
+        d2_A3(gather(samples, &Params::d2_A3)),
+        d3_0(gather(samples, &Params::d3_0)),
+        vso1_0(gather(samples, &Params::vso1_0)),
+        vso1_A(gather(samples, &Params::vso1_A)),
+        vso2_0(gather(samples, &Params::vso2_0)),
+        wso1_0(gather(samples, &Params::wso1_0)),
+        wso2_0(gather(samples, &Params::wso2_0)) {}
+
+  /// @brief reads every sample of a store in the KD03 JSON layout, as
+  /// KD03Params<p>(store.to_json(s)) would, copying whole columns
+  explicit KD03Ensemble(const SampleStore &store);
+
+  /// @returns number of samples
+  size_t size() const { return v1_0.size(); }
+
+  /// @brief writes the 18 parameters of get_global_terms for every sample;
+  /// out[k * stride + s] is parameter k of sample s
+  void evaluate(Isotope iso, real erg_cms, real *out, size_t stride) const;
+
+  /// @returns the 18 x size() parameters of get_global_terms, one column per
+  /// sample
+  xt::xtensor<real, 2> terms(Isotope iso, real erg_cms) const {
+    auto t = xt::xtensor<real, 2>::from_shape({18, size()});
+    evaluate(iso, erg_cms, t.data(), size());
+    return t;
+  }
+};
+
+/// @brief N samples of the CH89 parameters, e.g. draws from the CHUQ
+/// posterior, stored column-wise; see KD03Ensemble. Evaluates the accessors
+/// of CH89Params<Proj::neutron>, which CH89Params<Proj::proton> inherits
+class CH89Ensemble {
+private:
+  using Params = CH89Params<Proj::neutron>;
+
+  std::vector<real> r_0, r_A, a0;
+  std::vector<real> rw_0, rw_A, aw;
+  std::vector<real> rso_0, rso_A, aso;
+  std::vector<real> v_0, v_e, v_asym;
+  std::vector<real> wv_0, wve_0, wv_ew;
+  std::vector<real> ws_0, ws_asym, ws_e0, ws_ew;
+  std::vector<real> vso_0;
+
+  template <class Sample>
+  static std::vector<real> gather(const std::vector<Sample> &samples,
+                                  real Params::*field) {
+    auto column = std::vector<real>(samples.size());
+    for (size_t s = 0; s < samples.size(); ++s)
+      column[s] = static_cast<const Params &>(samples[s]).*field;
+    return column;
+  }
+
+public:
+  template <Proj p>
+  explicit CH89Ensemble(const std::vector<CH89Params<p>> &samples)
+      : r_0(gather(samples, &Params::r_0)), r_A(gather(samples, &Params::r_A)),
+        a0(gather(samples, &Params::a0)), rw_0(gather(samples, &Params::rw_0)),
+        rw_A(gather(samples, &Params::rw_A)),
+        aw(gather(samples, &Params::aw)),
+        rso_0(gather(samples, &Params::rso_0)),
+        rso_A(gather(samples, &Params::rso_A)),
+        aso(gather(samples, &Params::aso)),
+        v_0(gather(samples, &Params::v_0)), v_e(gather(samples, &Params::v_e)),
+        v_asym(gather(samples, &Params::v_asym)),
+        wv_0(gather(samples, &Params::wv_0)),
+        wve_0(gather(samples, &Params::wve_0)),
+        wv_ew(gather(samples, &Params::wv_ew)),
+        ws_0(gather(samples, &Params::ws_0)),
+        ws_asym(gather(samples, &Params::ws_asym)),
+        ws_e0(gather(samples, &Params::ws_e0)),
+        ws_ew(gather(samples, &Params::ws_ew)),
+        vso_0(gather(samples, &Params::vso_0)) {}
+
+  /// @brief reads every sample of a store in the CH89 JSON layout, as
+  /// CH89Params<p>(store.to_json(s)) would, copying whole columns
+  explicit CH89Ensemble(const SampleStore &store);
+
+  /// @returns number of samples
+  size_t size() const { return v_0.size(); }
+
+  /// @brief writes the 18 parameters of get_global_terms for every sample;
+  /// out[k * stride + s] is parameter k of sample s
+  void evaluate(Isotope iso, real erg_cms, real *out, size_t stride) const;
+
+  /// @returns the 18 x size() parameters of get_global_terms, one column per
+  /// sample
+  xt::xtensor<real, 2> terms(Isotope iso, real erg_cms) const {
+    auto t = xt::xtensor<real, 2>::from_shape({18, size()});
+    evaluate(iso, erg_cms, t.data(), size());
+    return t;
+  }
+};
+
+} // namespace osiris
+
+#endif
@@ -23,6 +23,12 @@ KD03Params<Proj::proton>::KD03Params(json p)
       rc_0(p["KDCoulomb"]["r_C_0"]), rc_A(p["KDCoulomb"]["r_C_A"]),
       rc_A2(p["KDCoulomb"]["r_C_A2"]) {}
 
+KD03Params<Proj::proton>::KD03Params(const SampleStore &store, size_t sample)
+    : KD03Params<Proj::neutron>(store, sample), OMParams<Proj::proton>(),
+      rc_0(store.row(sample)["KDCoulomb"]["r_C_0"]),
+      rc_A(store.row(sample)["KDCoulomb"]["r_C_A"]),
+      rc_A2(store.row(sample)["KDCoulomb"]["r_C_A2"]) {}
+
 KD03Params<Proj::proton>::KD03Params()
     : KD03Params<Proj::neutron>(), OMParams<Proj::proton>(), rc_0(1.2E0),
       rc_A(6.97E-1), rc_A2(1.3E1) {
@@ -44,6 +50,14 @@ real osiris::KD03Params<Proj::proton>::real_coul_r(int, int A, real) const {
   return rc_0 + rc_A * pow(a, -1. / 3.) + rc_A2 * pow(a, -5. / 3.);
 }
 
+KD03Params<Proj::proton>::Bound
+osiris::KD03Params<Proj::proton>::bind(int Z, int A) const {
+  const real a = static_cast<real>(A);
+  return {{KD03Params<Proj::neutron>::bind(Z, A)},
+          real_coul_V_outer(Z, A, 0),
+          real_coul_r(Z, A, 0) * pow(a, 1. / 3.)};
+}
+
 template <> KD03Params<Proj::neutron> KD03Params<Proj::neutron>::build_KDUQ() {
   KD03Params<Proj::neutron> p{};
   p.v1_0 = 5.86E1;
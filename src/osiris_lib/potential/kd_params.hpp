@@ -2,6 +2,7 @@
 #define KD_PARAMS_HEADER
 
 #include "potential/params_base.hpp"
+#include "potential/sample_store.hpp"
 #include "util/types.hpp"
 
 namespace osiris {
@@ -72,32 +73,102 @@ public:
   // @brief Construct using the default KD03 params
   KD03Params();
   // @brief  Construct using params supplied in a json file
-  KD03Params(json p)
-      : OMParams<projectile>(),
-        // same for n's and p's
-        rv_0(p["KDHartreeFock"]["r_0"]), rv_A(p["KDHartreeFock"]["r_A"]),
-        av_0(p["KDHartreeFock"]["a_0"]), av_A(p["KDHartreeFock"]["a_A"]),
-        rd_0(p["KDImagSurface"]["r_0"]), rd_A(p["KDImagSurface"]["r_A"]),
-        rso_0(p["KDRealSpinOrbit"]["r_0"]), rso_A(p["KDRealSpinOrbit"]["r_A"]),
-        aso_0(p["KDRealSpinOrbit"]["a_0"]),
-
-        v1_0(p["KDHartreeFock"]["V1_0"]), v1_asym(p["KDHartreeFock"]["V1_asymm"]),
-        v1_A(p["KDHartreeFock"]["V1_A"]), v4_0(p["KDHartreeFock"]["V4_0"]),
-
-        w2_0(p["KDImagVolume"]["W2_0"]), w2_A(p["KDImagVolume"]["W2_A"]),
-
-        d1_0(p["KDImagSurface"]["D1_0"]), d1_asym(p["KDImagSurface"]["D1_asymm"]),
-        d2_0(p["KDImagSurface"]["D2_0"]), d2_A(p["KDImagSurface"]["D2_A"]),
-        d2_A2(p["KDImagSurface"]["D2_A2"]), d2_A3(p["KDImagSurface"]["D2_A3"]),
-        d3_0(p["KDImagSurface"]["D3_0"]),
-
-        vso1_0(p["KDRealSpinOrbit"]["V1_0"]), vso1_A(p["KDRealSpinOrbit"]["V1_A"]),
+  KD03Params(json p) : OMParams<projectile>() { read(p); }
+  /// @brief Construct from a sample of a store in the JSON layout, reading
+  /// its columns directly
+  KD03Params(const SampleStore &store, size_t sample)
+      : OMParams<projectile>() {
+    read(store.row(sample));
+  }
 
-        vso2_0(p["KDRealSpinOrbit"]["V2_0"]), wso1_0(p["KDImagSpinOrbit"]["W1_0"]),
-        wso2_0(p["KDImagSpinOrbit"]["W2_0"])
+  /// @brief constructs a KD03Params\<p\> with params refit w/ MCMC; from
+  /// Pruitt, C. D. et al,
+  /// “Uncertainty-Quantified Phenomenological Optical Potentials
+  /// for Single-Nucleon Scattering”,
+  static KD03Params<projectile> build_KDUQ();
 
-  // different for neutrons and protons
-  {
+  /// @brief KD03 bound to a single target. The A- and Z-dependent factors,
+  /// e.g. A^(1/3), the asymmetry and the Fermi energy, are computed once by
+  /// bind, so each energy only costs the energy polynomials and exponentials.
+  /// Accessors take the energy alone and return exactly what the accessors of
+  /// the parameters it was bound from return for that target. Holds a pointer
+  /// to those parameters, which must outlive it
+  class Bound {
+  private:
+    friend class KD03Params<projectile>;
+
+    const KD03Params<projectile> *p;
+    real Ef;
+    real rv, av, rd, ad, rso;
+    real v1, v2, v3, w1, w2, d1, d2, vso1, vc;
+
+  public:
+    static constexpr bool charged = false;
+
+    real real_cent_r(real) const { return rv; }
+    real cmpl_cent_r(real) const { return rv; }
+    real real_surf_r(real) const { return 0; }
+    real cmpl_surf_r(real) const { return rd; }
+    real real_spin_r(real) const { return rso; }
+    real cmpl_spin_r(real) const { return rso; }
+
+    real real_cent_a(real) const { return av; }
+    real cmpl_cent_a(real) const { return av; }
+    real real_surf_a(real) const { return 0; }
+    real cmpl_surf_a(real) const { return ad; }
+    real real_spin_a(real) const { return p->aso_0; }
+    real cmpl_spin_a(real) const { return p->aso_0; }
+
+    real real_cent_V(real erg) const;
+    real cmpl_cent_V(real erg) const;
+    real real_surf_V(real) const { return 0; }
+    real cmpl_surf_V(real erg) const;
+    real real_spin_V(real erg) const;
+    real cmpl_spin_V(real erg) const;
+  };
+
+  /// @returns these parameters bound to the target Z, A
+  Bound bind(int Z, int A) const;
+
+private:
+  /// @brief reads the parameters from p["group"]["key"], p being a JSON
+  /// object or a SampleStore::Row
+  template <class Sample> void read(Sample &&p) {
+    // same for n's and p's
+    rv_0 = p["KDHartreeFock"]["r_0"];
+    rv_A = p["KDHartreeFock"]["r_A"];
+    av_0 = p["KDHartreeFock"]["a_0"];
+    av_A = p["KDHartreeFock"]["a_A"];
+    rd_0 = p["KDImagSurface"]["r_0"];
+    rd_A = p["KDImagSurface"]["r_A"];
+    rso_0 = p["KDRealSpinOrbit"]["r_0"];
+    rso_A = p["KDRealSpinOrbit"]["r_A"];
+    aso_0 = p["KDRealSpinOrbit"]["a_0"];
+
+    v1_0 = p["KDHartreeFock"]["V1_0"];
+    v1_asym = p["KDHartreeFock"]["V1_asymm"];
+    v1_A = p["KDHartreeFock"]["V1_A"];
+    v4_0 = p["KDHartreeFock"]["V4_0"];
+
+    w2_0 = p["KDImagVolume"]["W2_0"];
+    w2_A = p["KDImagVolume"]["W2_A"];
+
+    d1_0 = p["KDImagSurface"]["D1_0"];
+    d1_asym = p["KDImagSurface"]["D1_asymm"];
+    d2_0 = p["KDImagSurface"]["D2_0"];
+    d2_A = p["KDImagSurface"]["D2_A"];
+    d2_A2 = p["KDImagSurface"]["D2_A2"];
+    d2_A3 = p["KDImagSurface"]["D2_A3"];
+    d3_0 = p["KDImagSurface"]["D3_0"];
+
+    vso1_0 = p["KDRealSpinOrbit"]["V1_0"];
+    vso1_A = p["KDRealSpinOrbit"]["V1_A"];
+
+    vso2_0 = p["KDRealSpinOrbit"]["V2_0"];
+    wso1_0 = p["KDImagSpinOrbit"]["W1_0"];
+    wso2_0 = p["KDImagSpinOrbit"]["W2_0"];
+
+    // different for neutrons and protons
     if constexpr (projectile == Proj::neutron) {
       e_fermi_0 = -11.2814;
       e_fermi_A = 0.02646;
@@ -121,19 +192,17 @@ public:
       w1_0 = p["KDImagVolume"]["W1_0_p"];
       w1_A = p["KDImagVolume"]["W1_A_p"];
     }
+    // optional, for samples that vary the Fermi energy
+    if (p.contains("KDFermi")) {
+      e_fermi_0 = p["KDFermi"]["E_f_0"];
+      e_fermi_A = p["KDFermi"]["E_f_A"];
+    }
   }
-
-  /// @brief constructs a KD03Params<p> with params refit w/ MCMC; from
-  /// @brief constructs a KD03Params\<p\> with params refit w/ MCMC; from
-  /// Pruitt, C. D. et al,
-  /// “Uncertainty-Quantified Phenomenological Optical Potentials
-  /// for Single-Nucleon Scattering”,
-  static KD03Params<projectile> build_KDUQ();
 };
 
 template <>
 class KD03Params<Proj::proton> : public KD03Params<Proj::neutron>,
-                                 OMParams<Proj::proton> {
+                                 public OMParams<Proj::proton> {
 protected:
   real rc_0, rc_A, rc_A2;
 
@@ -144,7 +213,21 @@ public:
   KD03Params(const KD03Params<Proj::proton> &rhs) = default;
   KD03Params();
   KD03Params(json p);
+  KD03Params(const SampleStore &store, size_t sample);
   static KD03Params<Proj::proton> build_KDUQ();
+
+  /// @brief KD03Params<Proj::neutron>::Bound plus the energy-independent
+  /// Coulomb term of get_coulomb_term
+  struct Bound : KD03Params<Proj::neutron>::Bound {
+    static constexpr bool charged = true;
+    /// @brief Z e^2 [MeV fm]
+    real coul_q2;
+    /// @brief radius of the uniformly charged sphere [fm]
+    real coul_R;
+  };
+
+  /// @returns these parameters bound to the target Z, A
+  Bound bind(int Z, int A) const;
 };
 
 // potential terms
@@ -280,5 +363,80 @@ real KD03Params<proj>::cmpl_spin_V(int, int A, real erg) const {
   return constants::csp * wso1 * dE * dE / (dE * dE + wso2 * wso2);
 }
 
+template <Proj proj>
+typename KD03Params<proj>::Bound KD03Params<proj>::bind(int Z, int A) const {
+  const real z = static_cast<real>(Z);
+  const real a = static_cast<real>(A);
+  const real a3 = pow(a, 1. / 3.);
+  const real alpha = asym(Z, A);
+
+  auto b = Bound{};
+  b.p = this;
+  b.Ef = Ef(A);
+  b.rv = rv_0 * a3 - rv_A;
+  b.av = av_0 - av_A * a;
+  b.rd = rd_0 * a3 - rd_A * a3 * a3;
+  b.rso = rso_0 * a3 - rso_A;
+  b.v1 = v1_0 - v1_A * a + v1_asym * alpha;
+  b.w1 = w1_0 + w1_A * a;
+  b.w2 = w2_0 + w2_A * a;
+  b.d1 = d1_0 + d1_asym * alpha;
+  b.d2 = d2_0 + d2_A / (1 + exp((a - d2_A3) / d2_A2));
+  b.vso1 = vso1_0 + vso1_A * a;
+  b.vc = 0;
+  if constexpr (proj == Proj::neutron) {
+    b.ad = ad_0 - ad_A * a;
+    b.v2 = v2_0 - v2_A * a;
+    b.v3 = v3_0 - v3_A * a;
+  } else if constexpr (proj == Proj::proton) {
+    const real rc = KD03Params<Proj::proton>::real_coul_r(Z, A, 0);
+    b.ad = ad_0 + ad_A * a;
+    b.v2 = v2_0 + v2_A * a;
+    b.v3 = v3_0 + v3_A * a;
+    b.vc = 6 * z * constants::e_sqr / (5 * rc * a3);
+  }
+  return b;
+}
+
+template <Proj proj>
+real KD03Params<proj>::Bound::real_cent_V(real erg) const {
+  const real dE = erg - Ef;
+  const real v4 = p->v4_0;
+
+  if constexpr (proj == Proj::neutron) {
+    return -v1 * (1. - v2 * dE + v3 * dE * dE - v4 * dE * dE * dE);
+  } else if constexpr (proj == Proj::proton) {
+    return -(v1 * (1. - v2 * dE + v3 * dE * dE - v4 * dE * dE * dE) +
+             vc * v1 * (v2 - 2. * v3 * dE + 3. * v4 * dE * dE));
+  }
+}
+
+template <Proj proj>
+real KD03Params<proj>::Bound::cmpl_cent_V(real erg) const {
+  const real dE = erg - Ef;
+  return -w1 * dE * dE / (dE * dE + w2 * w2);
+}
+
+template <Proj proj>
+real KD03Params<proj>::Bound::cmpl_surf_V(real erg) const {
+  const real dE = erg - Ef;
+  const real d3 = p->d3_0;
+  return 4 * ad * d1 * dE * dE / (dE * dE + d3 * d3) * exp(-d2 * dE);
+}
+
+template <Proj proj>
+real KD03Params<proj>::Bound::real_spin_V(real erg) const {
+  const real dE = erg - Ef;
+  return constants::csp * vso1 * exp(-p->vso2_0 * dE);
+}
+
+template <Proj proj>
+real KD03Params<proj>::Bound::cmpl_spin_V(real erg) const {
+  const real dE = erg - Ef;
+  const real wso1 = p->wso1_0;
+  const real wso2 = p->wso2_0;
+  return constants::csp * wso1 * dE * dE / (dE * dE + wso2 * wso2);
+}
+
 } // namespace osiris
 #endif
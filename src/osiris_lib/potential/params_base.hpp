@@ -79,13 +79,15 @@ protected:
 template <> struct OMParams<Proj::proton> {
   virtual real real_coul_r(int Z, int A, real erg) const = 0;
 
-  /// @brief Coulomb potential w/in uniformly charge sphere or radius R
-  /// v(r) = q^2/(2*R)(3 - r/R)
+  /// @brief Coulomb potential outside a uniformly charged sphere of radius R
+  /// v(r) = q^2/r
+  /// @returns q^2 [MeV fm]
   virtual real real_coul_V_outer(int Z, int, real) const {
     return static_cast<real>(Z) * constants::e_sqr;
   }
-  /// @brief Coulomb potential outside uniformly charge sphere or radius R
-  /// v(r) = q^2/r
+  /// @brief Coulomb potential within a uniformly charged sphere of radius R
+  /// v(r) = q^2/(2*R)(3 - r^2/R^2)
+  /// @returns q^2/(2*R) [MeV]
   virtual real real_coul_V_inner(int Z, int A, real erg) const {
     const real a = static_cast<real>(A);
     const real z = static_cast<real>(Z);
@@ -10,6 +10,9 @@
 #include <xtensor/xtensor.hpp>
 #include <xtensor/xview.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <complex>
 #include <memory>
 #include <type_traits>
@@ -26,15 +29,62 @@ template <class T,
           typename std::enable_if_t<xt::is_xexpression<T>::value, bool> = true>
 struct Potential {
   virtual cmpl operator()(real r, T params) const = 0;
+
+  /// @brief evaluates the potential on a mesh, out[i] = V(r[i]) for i < n.
+  /// Implementations should override this to hoist parameter handling out of
+  /// the loop over radii, leaving a branch-free loop the compiler can
+  /// vectorize
+  virtual void batch(const real *r, size_t n, const T &params,
+                     cmpl *out) const {
+    for (size_t i = 0; i < n; ++i)
+      out[i] = operator()(r[i], params);
+  }
 };
 
-/// @brief Abstract interface for a non-local potential that is symmetric in the
-/// arguments e.g. V(r1,r2) = V(r2,r1)
+namespace detail {
+
+/// @returns V / (1 + exp((r - R) / a))
+inline real woods_saxon(real r, real V, real R, real a) {
+  return V / (1. + exp((r - R) / a));
+}
+
+/// @returns d/dr of woods_saxon(r, V, R, a)
+inline real deriv_woods_saxon(real r, real V, real R, real a) {
+  const auto y = exp((r - R) / a);
+  return -V / a * (y / ((1. + y) * (1. + y)));
+}
+
+/// @returns the potential of a uniformly charged sphere of radius Rc [fm],
+/// q2 / (2 Rc) (3 - r^2 / Rc^2) inside and q2 / r outside, q2 = Z z e^2
+/// [MeV fm]
+inline real uniform_sphere_coulomb(real r, real q2, real Rc) {
+  if (r < Rc)
+    return q2 / (2 * Rc) * (3 - r * r / (Rc * Rc));
+  return q2 / r;
+}
+
+} // namespace detail
+
+/// @brief Abstract interface for a non-local potential V(r1, r2). Most are
+/// symmetric in the arguments, V(r1,r2) = V(r2,r1), which solvers exploit by
+/// evaluating one triangle only; those that aren't override is_symmetric
 template <class T,
           typename std::enable_if_t<xt::is_xexpression<T>::value, bool> = true>
 struct NonlocalPotential {
-  constexpr static bool is_symmetric = true;
   virtual cmpl operator()(real r, real rp, T params) const = 0;
+
+  /// @returns whether V(r1,r2) = V(r2,r1) for these params
+  virtual bool is_symmetric(const T &) const { return true; }
+
+  /// @brief evaluates a tile of the potential, out[i * nrp + j] = V(r[i],
+  /// rp[j]). Implementations should override this to hoist parameter handling
+  /// out of the loop over pairs
+  virtual void tile(const real *r, size_t nr, const real *rp, size_t nrp,
+                    const T &params, cmpl *out) const {
+    for (size_t i = 0; i < nr; ++i)
+      for (size_t j = 0; j < nrp; ++j)
+        out[i * nrp + j] = operator()(r[i], rp[j], params);
+  }
 };
 
 /// @brief Common phenomenological potential form used for central potentials
@@ -46,8 +96,22 @@ template <class T> struct WoodsSaxon : public Potential<T> {
     auto a = params(2);
     if (fabs(a) < 1e-12)
       return 0;
-    return V / (1. + exp((r - R) / a));
+    return detail::woods_saxon(r, V, R, a);
   };
+
+  void batch(const real *r, size_t n, const T &params,
+             cmpl *out) const final {
+    assert(params.size() == 3);
+    const real V = params(0);
+    const real R = params(1);
+    const real a = params(2);
+    if (fabs(a) < 1e-12) {
+      std::fill(out, out + n, cmpl{0});
+      return;
+    }
+    for (size_t i = 0; i < n; ++i)
+      out[i] = detail::woods_saxon(r[i], V, R, a);
+  }
 };
 
 /// @brief Common phenomenological potential form used for surface peakes
@@ -61,9 +125,22 @@ template <class T> struct DerivWoodsSaxon : public Potential<T> {
     auto a = params(2);
     if (fabs(a) < 1e-12)
       return 0;
-    const auto y = exp((r - R) / a);
-    return -V / a * (y / ((1. + y) * (1. + y)));
+    return detail::deriv_woods_saxon(r, V, R, a);
   };
+
+  void batch(const real *r, size_t n, const T &params,
+             cmpl *out) const final {
+    assert(params.size() == 3);
+    const real V = params(0);
+    const real R = params(1);
+    const real a = params(2);
+    if (fabs(a) < 1e-12) {
+      std::fill(out, out + n, cmpl{0});
+      return;
+    }
+    for (size_t i = 0; i < n; ++i)
+      out[i] = detail::deriv_woods_saxon(r[i], V, R, a);
+  }
 };
 
 /// @brief Common phenomenological potential form used for spin orbit potentials
@@ -72,16 +149,34 @@ template <class T> struct Thomas : public Potential<T> {
   cmpl operator()(real r, T params) const final {
     return DerivWoodsSaxon<T>{}(r, params) / r;
   };
+
+  void batch(const real *r, size_t n, const T &params,
+             cmpl *out) const final {
+    DerivWoodsSaxon<T>{}.batch(r, n, params, out);
+    for (size_t i = 0; i < n; ++i)
+      out[i] /= r[i];
+  }
 };
 
+/// @brief V exp(-(r - R)^2 / sigma^2)
 template <class T> struct Gaussian : public Potential<T> {
   cmpl operator()(real r, T params) const final {
     assert(params.size() == 3);
     auto V = params(0);
     auto R = params(1);
     auto sigma = params(2);
-    return exp((r - R) * (r - R) / (sigma * sigma));
+    return V * exp(-(r - R) * (r - R) / (sigma * sigma));
   };
+
+  void batch(const real *r, size_t n, const T &params,
+             cmpl *out) const final {
+    assert(params.size() == 3);
+    const real V = params(0);
+    const real R = params(1);
+    const real inv_sigma2 = 1. / (params(2) * params(2));
+    for (size_t i = 0; i < n; ++i)
+      out[i] = V * exp(-(r[i] - R) * (r[i] - R) * inv_sigma2);
+  }
 };
 
 template <size_t N, class T> struct NGaussian : public Potential<T> {
@@ -112,6 +207,15 @@ template <class T> struct Yukawa : public Potential<T> {
     real force_coupling = params(1);
     return -force_coupling * exp(-r / mass_coupling) / r;
   };
+
+  void batch(const real *r, size_t n, const T &params,
+             cmpl *out) const final {
+    assert(params.size() == 2);
+    const real mass_coupling = params(0);
+    const real force_coupling = params(1);
+    for (size_t i = 0; i < n; ++i)
+      out[i] = -force_coupling * exp(-r[i] / mass_coupling) / r[i];
+  }
 };
 
 template <class T> struct SphereWell : public Potential<T> {
@@ -125,6 +229,239 @@ template <class T> struct SphereWell : public Potential<T> {
   };
 };
 
+/// @brief Depth [MeV], radius [fm] and diffuseness [fm] of one term of an OMP
+struct OMPTerm {
+  real V{};
+  real R{};
+  real a{};
+};
+
+/// @brief Coulomb potential of a uniformly charged sphere, see
+/// detail::uniform_sphere_coulomb
+struct CoulombTerm {
+  /// @brief Z_p Z_t e^2 [MeV fm]; zero for a neutral projectile
+  real q2{};
+  /// @brief radius of the charged sphere [fm]; zero for a point charge
+  real Rc{};
+};
+
+/// @brief The 18 parameters of an OMP as a plain aggregate, in the order of
+/// get_global_terms, so a parameter set lives on the stack and is evaluated
+/// without views. Volume terms take Woods-Saxon form factors, surface terms
+/// their derivative and spin-orbit terms their derivative times 1/r. Charged
+/// projectiles add a Coulomb term, in the order of get_global_proton_terms
+struct OMPTerms {
+  OMPTerm real_cent;
+  OMPTerm cmpl_cent;
+  OMPTerm real_surf;
+  OMPTerm cmpl_surf;
+  OMPTerm real_spin;
+  OMPTerm cmpl_spin;
+  CoulombTerm coulomb{};
+
+  /// @brief OMP::central, plus the Coulomb term, at each of n radii
+  void central(const real *r, size_t n, cmpl *out) const;
+  /// @brief OMP::spin_orbit at each of n radii
+  void spin_orbit(const real *r, size_t n, cmpl *out) const;
+  /// @brief central + l_dot_s * spin_orbit at each of n radii
+  void evaluate(const real *r, size_t n, real l_dot_s, cmpl *out) const;
+  /// @brief derivatives of evaluate with respect to each of the 18
+  /// parameters, in the order of get_global_terms, at each of n radii;
+  /// out[k * n + i] = d/dp_k V(r[i]). Terms switched off by a vanishing
+  /// diffuseness have zero derivatives
+  void gradient(const real *r, size_t n, real l_dot_s, cmpl *out) const;
+
+  /// @returns the 18-element parameter array of get_global_terms, or the
+  /// 20-element one of get_global_proton_terms if there is a Coulomb term
+  xt::xtensor<real, 1> to_array() const {
+    if (coulomb.q2 != 0.)
+      return {real_cent.V, real_cent.R, real_cent.a, cmpl_cent.V, cmpl_cent.R,
+              cmpl_cent.a, real_surf.V, real_surf.R, real_surf.a, cmpl_surf.V,
+              cmpl_surf.R, cmpl_surf.a, real_spin.V, real_spin.R, real_spin.a,
+              cmpl_spin.V, cmpl_spin.R, cmpl_spin.a, coulomb.q2, coulomb.Rc};
+    return {real_cent.V, real_cent.R, real_cent.a, cmpl_cent.V, cmpl_cent.R,
+            cmpl_cent.a, real_surf.V, real_surf.R, real_surf.a, cmpl_surf.V,
+            cmpl_surf.R, cmpl_surf.a, real_spin.V, real_spin.R, real_spin.a,
+            cmpl_spin.V, cmpl_spin.R, cmpl_spin.a};
+  }
+};
+
+/// @returns OMPTerms from the 18-element parameter array of get_global_terms,
+/// or the 20-element one of get_global_proton_terms
+template <class T,
+          typename std::enable_if_t<xt::is_xexpression<T>::value, bool> = true>
+OMPTerms to_omp_terms(const T &params) {
+  assert(params.size() == 18 or params.size() == 20);
+  auto terms = OMPTerms{{params(0), params(1), params(2)},
+                        {params(3), params(4), params(5)},
+                        {params(6), params(7), params(8)},
+                        {params(9), params(10), params(11)},
+                        {params(12), params(13), params(14)},
+                        {params(15), params(16), params(17)}};
+  if (params.size() == 20)
+    terms.coulomb = {params(18), params(19)};
+  return terms;
+}
+
+inline OMPTerms to_omp_terms(const OMPTerms &terms) { return terms; }
+
+namespace detail {
+
+/// @brief Terms of an OMP sharing a Woods-Saxon geometry (R, a). With y =
+/// exp((r - R)/a), the volume form f = 1/(1 + y), the surface form f' = -y
+/// f^2 / a and the spin-orbit form f'/r all follow from a single exponential
+struct OMPGeometry {
+  real R{};
+  real a{};
+  /// @brief depths multiplying f, f' and f'/r, real part from the real term
+  /// and imaginary part from the imaginary term
+  cmpl volume{};
+  cmpl surface{};
+  cmpl spin_orbit{};
+};
+
+/// @brief the terms of an OMP grouped by distinct (R, a), e.g. the real and
+/// imaginary volume terms of KD03 and CH89 share a geometry, so the loops
+/// over radii evaluate one exponential per geometry rather than one per term
+class OMPFormFactors {
+private:
+  std::array<OMPGeometry, 6> geometries{};
+  size_t size{};
+  CoulombTerm coulomb{};
+
+  void add(const OMPTerm &term, cmpl OMPGeometry::*form, bool imaginary) {
+    // diffusenesses below 1e-12 fm switch a term off, as in WoodsSaxon
+    if (fabs(term.a) < 1e-12)
+      return;
+    const auto depth = imaginary ? cmpl{0, term.V} : cmpl{term.V, 0};
+    for (size_t g = 0; g < size; ++g) {
+      if (geometries[g].R == term.R and geometries[g].a == term.a) {
+        geometries[g].*form += depth;
+        return;
+      }
+    }
+    geometries[size] = OMPGeometry{term.R, term.a};
+    geometries[size++].*form += depth;
+  }
+
+public:
+  explicit OMPFormFactors(const OMPTerms &terms) : coulomb(terms.coulomb) {
+    add(terms.real_cent, &OMPGeometry::volume, false);
+    add(terms.cmpl_cent, &OMPGeometry::volume, true);
+    add(terms.real_surf, &OMPGeometry::surface, false);
+    add(terms.cmpl_surf, &OMPGeometry::surface, true);
+    add(terms.real_spin, &OMPGeometry::spin_orbit, false);
+    add(terms.cmpl_spin, &OMPGeometry::spin_orbit, true);
+  }
+
+  /// @brief out[i] = central_scale * central(r[i]) + spin_orbit_scale *
+  /// spin_orbit(r[i])
+  void evaluate(const real *r, size_t n, real central_scale,
+                real spin_orbit_scale, cmpl *out) const {
+    std::fill(out, out + n, cmpl{0});
+    for (size_t g = 0; g < size; ++g) {
+      const auto &geo = geometries[g];
+      const cmpl volume = central_scale * geo.volume;
+      const cmpl surface = central_scale * geo.surface;
+      const cmpl spin_orbit = spin_orbit_scale * geo.spin_orbit;
+      if (volume == 0. and surface == 0. and spin_orbit == 0.)
+        continue;
+      for (size_t i = 0; i < n; ++i) {
+        const real y = exp((r[i] - geo.R) / geo.a);
+        const real f = 1. / (1. + y);
+        const real df = -y * f * f / geo.a;
+        out[i] += volume * f + surface * df + spin_orbit * (df / r[i]);
+      }
+    }
+
+    if (coulomb.q2 == 0. or central_scale == 0.)
+      return;
+    const auto q2 = central_scale * coulomb.q2;
+    const auto Rc = coulomb.Rc;
+    if (not std::is_sorted(r, r + n)) {
+      for (size_t i = 0; i < n; ++i)
+        out[i] += uniform_sphere_coulomb(r[i], q2, Rc);
+      return;
+    }
+    // on an ascending mesh the radii inside the sphere come first, so both
+    // pieces are branch-free loops
+    const auto split = static_cast<size_t>(std::lower_bound(r, r + n, Rc) - r);
+    const auto inner = q2 / (2 * Rc);
+    for (size_t i = 0; i < split; ++i)
+      out[i] += inner * (3 - r[i] * r[i] / (Rc * Rc));
+    for (size_t i = split; i < n; ++i)
+      out[i] += q2 / r[i];
+  }
+};
+
+} // namespace detail
+
+inline void OMPTerms::central(const real *r, size_t n, cmpl *out) const {
+  detail::OMPFormFactors(*this).evaluate(r, n, 1., 0., out);
+}
+
+inline void OMPTerms::spin_orbit(const real *r, size_t n, cmpl *out) const {
+  detail::OMPFormFactors(*this).evaluate(r, n, 0., 1., out);
+}
+
+inline void OMPTerms::evaluate(const real *r, size_t n, real l_dot_s,
+                               cmpl *out) const {
+  detail::OMPFormFactors(*this).evaluate(r, n, 1., l_dot_s, out);
+}
+
+namespace detail {
+
+/// @brief d/dV, d/dR and d/da of factor * V * F(r) for F the Woods-Saxon form
+/// f = 1/(1 + y), y = exp(u), u = (r - R)/a, when form is 0, its derivative
+/// f' = -f(1 - f)/a when form is 1, or f'/r when form is 2, at each of n radii
+inline void omp_term_gradient(const OMPTerm &term, int form, cmpl factor,
+                              const real *r, size_t n, cmpl *dV, cmpl *dR,
+                              cmpl *da) {
+  if (fabs(term.a) < 1e-12) {
+    std::fill(dV, dV + n, cmpl{0});
+    std::fill(dR, dR + n, cmpl{0});
+    std::fill(da, da + n, cmpl{0});
+    return;
+  }
+  const auto [V, R, a] = term;
+  for (size_t i = 0; i < n; ++i) {
+    const real u = (r[i] - R) / a;
+    const real f = 1. / (1. + exp(u));
+    const real h = f * (1. - f);
+    real F, dF_dR, dF_da;
+    if (form == 0) {
+      F = f;
+      dF_dR = h / a;
+      dF_da = h * u / a;
+    } else {
+      const real scale = form == 2 ? 1. / r[i] : 1.;
+      F = -h / a * scale;
+      dF_dR = -h * (1. - 2. * f) / (a * a) * scale;
+      dF_da = h * (1. - (1. - 2. * f) * u) / (a * a) * scale;
+    }
+    dV[i] = factor * F;
+    dR[i] = factor * V * dF_dR;
+    da[i] = factor * V * dF_da;
+  }
+}
+
+} // namespace detail
+
+inline void OMPTerms::gradient(const real *r, size_t n, real l_dot_s,
+                               cmpl *out) const {
+  const auto i = constants::i;
+  const auto term = [&](const OMPTerm &t, size_t k, int form, cmpl factor) {
+    detail::omp_term_gradient(t, form, factor, r, n, out + k * n,
+                              out + (k + 1) * n, out + (k + 2) * n);
+  };
+  term(real_cent, 0, 0, 1.);
+  term(cmpl_cent, 3, 0, i);
+  term(real_surf, 6, 1, 1.);
+  term(cmpl_surf, 9, 1, i);
+  term(real_spin, 12, 2, l_dot_s);
+  term(cmpl_spin, 15, 2, i * l_dot_s);
+}
+
 /// @brief Common optical model potential form
 template <class T> struct OMP : public Potential<T> {
   using View = ViewType<T>;
@@ -132,19 +469,94 @@ template <class T> struct OMP : public Potential<T> {
 
   OMP(real l_dot_s) : l_dot_s(l_dot_s){};
 
-  cmpl operator()(real r, T params) const final {
+  /// @returns the spin-independent part of the potential at r: real and
+  /// imaginary Woods-Saxon volume terms plus Woods-Saxon derivative surface
+  /// terms
+  static cmpl central(real r, const T &params) {
     assert(params.size() == 18);
+    const auto real_cent = xt::view(params, xt::range(0, 3));
+    const auto cmpl_cent = xt::view(params, xt::range(3, 6));
+    const auto real_surf = xt::view(params, xt::range(6, 9));
+    const auto cmpl_surf = xt::view(params, xt::range(9, 12));
+    using ConstView = std::decay_t<decltype(real_cent)>;
+    return WoodsSaxon<ConstView>{}(r, real_cent) +
+           DerivWoodsSaxon<ConstView>{}(r, real_surf) +
+           WoodsSaxon<ConstView>{}(r, cmpl_cent) * constants::i +
+           DerivWoodsSaxon<ConstView>{}(r, cmpl_surf) * constants::i;
+  }
+
+  /// @returns the spin-orbit form factor at r, to be multiplied by L * S
+  static cmpl spin_orbit(real r, const T &params) {
+    assert(params.size() == 18);
+    const auto real_spin = xt::view(params, xt::range(12, 15));
+    const auto cmpl_spin = xt::view(params, xt::range(15, 18));
+    using ConstView = std::decay_t<decltype(real_spin)>;
+    return Thomas<ConstView>{}(r, real_spin) +
+           Thomas<ConstView>{}(r, cmpl_spin) * constants::i;
+  }
+
+  /// @brief central(r[i], params) for each of n radii
+  static void central(const real *r, size_t n, const T &params, cmpl *out) {
+    to_omp_terms(params).central(r, n, out);
+  }
+
+  /// @brief spin_orbit(r[i], params) for each of n radii
+  static void spin_orbit(const real *r, size_t n, const T &params,
+                         cmpl *out) {
+    to_omp_terms(params).spin_orbit(r, n, out);
+  }
+
+  cmpl operator()(real r, T params) const final {
+    return central(r, params) + spin_orbit(r, params) * l_dot_s;
+  }
+
+  cmpl operator()(real r, const OMPTerms &terms) const {
+    cmpl v = 0;
+    terms.evaluate(&r, 1, l_dot_s, &v);
+    return v;
+  }
 
-    return cmpl{WoodsSaxon<View>{}(r, xt::view(params, xt::range(0, 3))) +
-                DerivWoodsSaxon<View>{}(r, xt::view(params, xt::range(6, 9))) +
-                Thomas<View>{}(r, xt::view(params, xt::range(12, 15))) *
-                    l_dot_s +
-                WoodsSaxon<View>{}(r, xt::view(params, xt::range(3, 6))) *
-                    constants::i +
-                DerivWoodsSaxon<View>{}(r, xt::view(params, xt::range(9, 12))) *
-                    constants::i +
-                Thomas<View>{}(r, xt::view(params, xt::range(15, _))) *
-                    l_dot_s * constants::i};
+  void batch(const real *r, size_t n, const T &params,
+             cmpl *out) const final {
+    to_omp_terms(params).evaluate(r, n, l_dot_s, out);
+  }
+
+  void batch(const real *r, size_t n, const OMPTerms &terms,
+             cmpl *out) const {
+    terms.evaluate(r, n, l_dot_s, out);
+  }
+
+  /// @brief analytic derivatives with respect to each of the 18 parameters at
+  /// each of n radii, out[k * n + i], see OMPTerms::gradient
+  void gradient(const real *r, size_t n, const T &params, cmpl *out) const {
+    to_omp_terms(params).gradient(r, n, l_dot_s, out);
+  }
+};
+
+/// @brief OMP of a proton: the nuclear terms of OMP plus the Coulomb potential
+/// of a uniformly charged sphere, which batch adds inside the same mesh loop.
+/// Takes the 20 parameters of get_global_proton_terms
+template <class T> struct ProtonOMP : public Potential<T> {
+  real l_dot_s{};
+
+  ProtonOMP(real l_dot_s) : l_dot_s(l_dot_s){};
+
+  /// @returns the Coulomb potential at r
+  static real coulomb(real r, const T &params) {
+    assert(params.size() == 20);
+    return detail::uniform_sphere_coulomb(r, params(18), params(19));
+  }
+
+  cmpl operator()(real r, T params) const final {
+    assert(params.size() == 20);
+    const T nuclear = xt::view(params, xt::range(0, 18));
+    return OMP<T>(l_dot_s)(r, nuclear) + coulomb(r, params);
+  }
+
+  void batch(const real *r, size_t n, const T &params,
+             cmpl *out) const final {
+    assert(params.size() == 20);
+    to_omp_terms(params).evaluate(r, n, l_dot_s, out);
   }
 };
 
@@ -164,11 +576,135 @@ xt::xtensor<real, 1> get_global_terms(Isotope iso, real erg_cms,
           p.cmpl_spin_r(Z, A, erg_cms), p.cmpl_spin_a(Z, A, erg_cms)};
 }
 
-/// @brief An arbitrary local potential in r smeared into the off-diagonal
-/// by a Gaussian factor in (r-rp), from:
+/// @returns the Coulomb term of a proton OMP: the target charge times e^2 and
+/// the radius of the uniformly charged sphere, r_c A^(1/3)
+template <class GlobalParamsOMP>
+CoulombTerm get_coulomb_term(Isotope iso, real erg_cms,
+                             const GlobalParamsOMP &p) {
+  const auto A = iso.A;
+  const auto Z = iso.Z;
+  return {p.real_coul_V_outer(Z, A, erg_cms),
+          p.real_coul_r(Z, A, erg_cms) * pow(static_cast<real>(A), 1. / 3.)};
+}
+
+/// @returns the same terms as get_global_terms as an OMPTerms, without
+/// allocating. For proton parameters the Coulomb term is included
+template <class GlobalParamsOMP>
+OMPTerms get_omp_terms(Isotope iso, real erg_cms, const GlobalParamsOMP &p) {
+  const auto A = iso.A;
+  const auto Z = iso.Z;
+  auto terms = OMPTerms{
+      {p.real_cent_V(Z, A, erg_cms), p.real_cent_r(Z, A, erg_cms),
+       p.real_cent_a(Z, A, erg_cms)},
+      {p.cmpl_cent_V(Z, A, erg_cms), p.cmpl_cent_r(Z, A, erg_cms),
+       p.cmpl_cent_a(Z, A, erg_cms)},
+      {p.real_surf_V(Z, A, erg_cms), p.real_surf_r(Z, A, erg_cms),
+       p.real_surf_a(Z, A, erg_cms)},
+      {p.cmpl_surf_V(Z, A, erg_cms), p.cmpl_surf_r(Z, A, erg_cms),
+       p.cmpl_surf_a(Z, A, erg_cms)},
+      {p.real_spin_V(Z, A, erg_cms), p.real_spin_r(Z, A, erg_cms),
+       p.real_spin_a(Z, A, erg_cms)},
+      {p.cmpl_spin_V(Z, A, erg_cms), p.cmpl_spin_r(Z, A, erg_cms),
+       p.cmpl_spin_a(Z, A, erg_cms)}};
+  if constexpr (std::is_base_of_v<OMParams<Proj::proton>, GlobalParamsOMP>)
+    terms.coulomb = get_coulomb_term(iso, erg_cms, p);
+  return terms;
+}
+
+/// @returns the terms of get_global_terms followed by the Coulomb term,
+/// q2 [MeV fm] and Rc [fm], of a proton OMP, as taken by ProtonOMP
+template <class GlobalParamsOMP>
+xt::xtensor<real, 1> get_global_proton_terms(Isotope iso, real erg_cms,
+                                             const GlobalParamsOMP &p) {
+  return get_omp_terms(iso, erg_cms, p).to_array();
+}
+
+/// @returns get_omp_terms for the target and parameters an isotope-bound
+/// evaluator was made from, e.g. KD03Params<p>::bind(Z, A). Only the energy
+/// dependence is evaluated, so prefer this for excitation functions
+template <class IsotopeBound>
+OMPTerms get_omp_terms(const IsotopeBound &b, real erg_cms) {
+  auto terms = OMPTerms{
+      {b.real_cent_V(erg_cms), b.real_cent_r(erg_cms), b.real_cent_a(erg_cms)},
+      {b.cmpl_cent_V(erg_cms), b.cmpl_cent_r(erg_cms), b.cmpl_cent_a(erg_cms)},
+      {b.real_surf_V(erg_cms), b.real_surf_r(erg_cms), b.real_surf_a(erg_cms)},
+      {b.cmpl_surf_V(erg_cms), b.cmpl_surf_r(erg_cms), b.cmpl_surf_a(erg_cms)},
+      {b.real_spin_V(erg_cms), b.real_spin_r(erg_cms), b.real_spin_a(erg_cms)},
+      {b.cmpl_spin_V(erg_cms), b.cmpl_spin_r(erg_cms),
+       b.cmpl_spin_a(erg_cms)}};
+  if constexpr (IsotopeBound::charged)
+    terms.coulomb = {b.coul_q2, b.coul_R};
+  return terms;
+}
+
+/// @returns get_global_terms for the target and parameters an isotope-bound
+/// evaluator was made from, e.g. KD03Params<p>::bind(Z, A)
+template <class IsotopeBound>
+xt::xtensor<real, 1> get_global_terms(const IsotopeBound &b, real erg_cms) {
+  auto terms = get_omp_terms(b, erg_cms);
+  terms.coulomb = {};
+  return terms.to_array();
+}
+
+/// @brief get_global_terms at m energies for one isotope-bound evaluator, as
+/// a structure of arrays: out[k * stride + j] is parameter k at ergs_cms[j].
+/// The accessors of a Bound are not virtual, so each parameter is one loop
+/// over the energies that the compiler can inline and vectorize
+template <class IsotopeBound>
+void get_global_terms(const IsotopeBound &b, const real *ergs_cms, size_t m,
+                      real *out, size_t stride) {
+  assert(stride >= m);
+  const auto fill = [=](size_t k, auto term) {
+    real *row = out + k * stride;
+    for (size_t j = 0; j < m; ++j)
+      row[j] = term(ergs_cms[j]);
+  };
+  fill(0, [&b](real e) { return b.real_cent_V(e); });
+  fill(1, [&b](real e) { return b.real_cent_r(e); });
+  fill(2, [&b](real e) { return b.real_cent_a(e); });
+  fill(3, [&b](real e) { return b.cmpl_cent_V(e); });
+  fill(4, [&b](real e) { return b.cmpl_cent_r(e); });
+  fill(5, [&b](real e) { return b.cmpl_cent_a(e); });
+  fill(6, [&b](real e) { return b.real_surf_V(e); });
+  fill(7, [&b](real e) { return b.real_surf_r(e); });
+  fill(8, [&b](real e) { return b.real_surf_a(e); });
+  fill(9, [&b](real e) { return b.cmpl_surf_V(e); });
+  fill(10, [&b](real e) { return b.cmpl_surf_r(e); });
+  fill(11, [&b](real e) { return b.cmpl_surf_a(e); });
+  fill(12, [&b](real e) { return b.real_spin_V(e); });
+  fill(13, [&b](real e) { return b.real_spin_r(e); });
+  fill(14, [&b](real e) { return b.real_spin_a(e); });
+  fill(15, [&b](real e) { return b.cmpl_spin_V(e); });
+  fill(16, [&b](real e) { return b.cmpl_spin_r(e); });
+  fill(17, [&b](real e) { return b.cmpl_spin_a(e); });
+}
+
+/// @returns get_global_terms over the grid of isotopes x energies as an
+/// 18 x (isotopes.size() * ergs_cms.size()) structure of arrays; column
+/// i * ergs_cms.size() + j holds isotopes[i] at ergs_cms[j]. Each isotope is
+/// bound once, and p is used through its static type, so GlobalParamsOMP must
+/// be one of the parameterizations providing bind
+template <class GlobalParamsOMP>
+xt::xtensor<real, 2> get_global_terms(const std::vector<Isotope> &isotopes,
+                                      const std::vector<real> &ergs_cms,
+                                      const GlobalParamsOMP &p) {
+  const auto nerg = ergs_cms.size();
+  const auto m = isotopes.size() * nerg;
+  auto terms = xt::xtensor<real, 2>::from_shape({18, m});
+  for (size_t i = 0; i < isotopes.size(); ++i) {
+    const auto b = p.bind(isotopes[i].Z, isotopes[i].A);
+    get_global_terms(b, ergs_cms.data(), nerg, terms.data() + i * nerg, m);
+  }
+  return terms;
+}
+
+/// @brief An arbitrary local potential U smeared into the off-diagonal by a
+/// Gaussian factor in (r-rp), V(r, rp) = U((r+rp)/2) H(r-rp), from:
 /// Perey, F., and B. Buck.
 /// "A non-local potential model for the scattering of neutrons by nuclei."
 /// Nuclear Physics 32 (1962): 353-380.
+/// The parameters are those of U followed by the three of the Gaussian H,
+/// V, R and sigma; the potential is symmetric when H is centered, R = 0
 template <class T> struct PereyBuck : public NonlocalPotential<T> {
   std::unique_ptr<Potential<ViewType<T>>> local_potential;
   Gaussian<T> non_local_factor;
@@ -177,37 +713,122 @@ template <class T> struct PereyBuck : public NonlocalPotential<T> {
       : local_potential(std::move(local_potential)){};
 
   cmpl operator()(real r, real rp, T params) const final {
-    return local_potential->operator()(r, xt::view(params, 0)) *
-           non_local_factor((r - rp), xt::view(params, xt::range(1, _)));
+    const auto n = static_cast<int>(params.size());
+    assert(n > 3);
+    return local_potential->operator()(0.5 * (r + rp),
+                                       xt::view(params, xt::range(0, n - 3))) *
+           non_local_factor(r - rp, xt::view(params, xt::range(n - 3, n)));
   };
+
+  bool is_symmetric(const T &params) const final {
+    return params(params.size() - 2) == 0;
+  }
+
+  void tile(const real *r, size_t nr, const real *rp, size_t nrp,
+            const T &params, cmpl *out) const final {
+    // the local potential takes a view into mutable parameters
+    auto p = T(params);
+    const auto n = static_cast<int>(p.size());
+    assert(n > 3);
+    const auto local_params = xt::view(p, xt::range(0, n - 3));
+    const T gaussian_params = xt::view(p, xt::range(n - 3, n));
+    auto mid = std::vector<real>(nrp);
+    auto diff = std::vector<real>(nrp);
+    auto local = std::vector<cmpl>(nrp);
+    auto factor = std::vector<cmpl>(nrp);
+    for (size_t i = 0; i < nr; ++i) {
+      for (size_t j = 0; j < nrp; ++j) {
+        mid[j] = 0.5 * (r[i] + rp[j]);
+        diff[j] = r[i] - rp[j];
+      }
+      local_potential->batch(mid.data(), nrp, local_params, local.data());
+      non_local_factor.batch(diff.data(), nrp, gaussian_params, factor.data());
+      for (size_t j = 0; j < nrp; ++j)
+        out[i * nrp + j] = local[j] * factor[j];
+    }
+  }
+};
+
+/// @brief Abstract interface for a separable non-local potential of finite
+/// rank, V(r, rp) = sum_n strength_n g_n(r) g_n(rp). Solvers detect this
+/// interface and treat the potential as a low-rank update of free propagation
+template <class T> struct SeparablePotential : public NonlocalPotential<T> {
+  /// @returns number of separable terms
+  virtual size_t rank() const = 0;
+  /// @returns g_n(r)
+  virtual real form_factor(size_t n, real r, const T &params) const = 0;
+  /// @returns strength_n [MeV fm^-1 when g_n is dimensionless]
+  virtual cmpl strength(size_t n, const T &params) const = 0;
+
+  cmpl operator()(real r, real rp, T params) const override {
+    cmpl v = 0;
+    for (size_t n = 0; n < rank(); ++n)
+      v += strength(n, params) * form_factor(n, r, params) *
+           form_factor(n, rp, params);
+    return v;
+  }
 };
 
 /// @brief Yamaguchi, Yoshio.
 /// "Two-nucleon problem when the potential is nonlocal but separable. I."
 /// Physical Review 95.6 (1954): 1628.
-/// @param mu reduced mass [amu]
+/// V(r, rp) = -f 2 beta (alpha + beta)^2 exp(-beta (r + rp))
 /// @param alpha [fm]^-1
 /// @param beta [fm]^-1
-template <class T> struct Yamaguchi : public NonlocalPotential<T> {
+/// @param f hbar^2/(2 mu) [MeV fm^2]
+template <class T> struct Yamaguchi : public SeparablePotential<T> {
 
   ///@brief parameters chosen to reproduce bound state of deuteron and
   /// and neutron-proton triplet scattering length
-  static constexpr T dn_triplet_params = {0.2316053, 1.3918324, 41.472};
+  static T dn_triplet_params() { return {0.2316053, 1.3918324, 41.472}; }
+
+  size_t rank() const final { return 1; }
+
+  real form_factor(size_t, real r, const T &params) const final {
+    return exp(-params(1) * r);
+  }
+
+  cmpl strength(size_t, const T &params) const final {
+    const auto alpha = params(0);
+    const auto beta = params(1);
+    const auto f = params(2);
+    return -f * 2 * beta * (alpha + beta) * (alpha + beta);
+  }
 
   cmpl operator()(real r, real rp, T params) const final {
     const auto alpha = params(0);
     const auto beta = params(1);
     const auto f = params(2);
-    return f * 2 * beta * (alpha + beta) * (alpha + beta) *
+    return -f * 2 * beta * (alpha + beta) * (alpha + beta) *
            exp(-beta * (r + rp));
   };
 
+  void tile(const real *r, size_t nr, const real *rp, size_t nrp,
+            const T &params, cmpl *out) const final {
+    const auto beta = params(1);
+    const auto v = strength(0, params);
+    auto form_rp = std::vector<real>(nrp);
+    for (size_t j = 0; j < nrp; ++j)
+      form_rp[j] = exp(-beta * rp[j]);
+    for (size_t i = 0; i < nr; ++i) {
+      const auto form_r = v * exp(-beta * r[i]);
+      for (size_t j = 0; j < nrp; ++j)
+        out[i * nrp + j] = form_r * form_rp[j];
+    }
+  }
+
+  /// @returns tan(delta) of the s-wave for wavenumber k [fm^-1], from the
+  /// effective-range expansion, exact for this potential,
+  /// k cot(delta) = -alpha beta (alpha + 2 beta) / d
+  ///                + k^2 (alpha^2 + 2 alpha beta + 3 beta^2) / (beta d)
+  ///                + k^4 / (beta d),
+  /// d = 2 (alpha + beta)^2, when f is hbar^2/(2 mu) of the scattering system
   real analytic_swave_kmatrix(real k, T params) const {
-    assert(params.size() == 2);
+    assert(params.size() == 3);
     const auto a = params(0);
     const auto b = params(1);
     const auto d = 2 * (a + b) * (a + b);
-    real cot_delta = (a * b * (a + 2 * b) / d +
+    real cot_delta = (-a * b * (a + 2 * b) / d +
                       k * k * (a * a + 2 * a * b + 3 * b * b) / (b * d) +
                       k * k * k * k / (b * d)) /
                      k;
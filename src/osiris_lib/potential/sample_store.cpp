@@ -0,0 +1,227 @@
+#include "potential/sample_store.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define OSIRIS_HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace osiris;
+
+namespace {
+
+constexpr char magic[8] = {'O', 'S', 'I', 'R', 'I', 'S', 'P', 'S'};
+constexpr size_t header_bytes = sizeof(magic) + 4 * sizeof(uint64_t);
+
+uint64_t read_u64(const char *p) {
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+void write_u64(std::ofstream &out, uint64_t v) {
+  out.write(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+} // namespace
+
+SampleStore::SampleStore(const std::string &path) : path(path) {
+  const auto fail = [&path](const std::string &why) {
+    return std::runtime_error("SampleStore: " + path + ": " + why);
+  };
+
+#ifdef OSIRIS_HAVE_MMAP
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw fail("can not open");
+  struct stat st {};
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    throw fail("can not stat");
+  }
+  bytes = static_cast<size_t>(st.st_size);
+  if (bytes > 0) {
+    void *map = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+      throw fail("can not map");
+    data = static_cast<const char *>(map);
+  } else {
+    ::close(fd);
+  }
+#else
+  auto in = std::ifstream(path, std::ios::binary | std::ios::ate);
+  if (not in)
+    throw fail("can not open");
+  bytes = static_cast<size_t>(in.tellg());
+  buffer.resize(bytes);
+  in.seekg(0);
+  in.read(buffer.data(), static_cast<std::streamsize>(bytes));
+  data = buffer.data();
+#endif
+
+  try {
+    if (bytes < header_bytes or std::memcmp(data, magic, sizeof(magic)) != 0)
+      throw fail("not a sample store");
+    if (read_u64(data + 8) != version)
+      throw fail("unsupported format version");
+    const auto nfields = read_u64(data + 16);
+    nsamples = read_u64(data + 24);
+    const auto name_bytes = read_u64(data + 32);
+    // the values must fill the rest of the file exactly; guard the product
+    // against overflow before comparing
+    constexpr auto max = std::numeric_limits<uint64_t>::max();
+    if (name_bytes % 8 != 0 or name_bytes > bytes - header_bytes or
+        (nfields != 0 and nsamples > max / sizeof(real) / nfields) or
+        bytes - header_bytes - name_bytes != nfields * nsamples * sizeof(real))
+      throw fail("truncated or corrupt");
+
+    const char *name = data + header_bytes;
+    const char *names_end = name + name_bytes;
+    fields.reserve(nfields);
+    for (size_t f = 0; f < nfields; ++f) {
+      const auto end = static_cast<const char *>(
+          std::memchr(name, '\0', static_cast<size_t>(names_end - name)));
+      if (end == nullptr)
+        throw fail("truncated or corrupt");
+      fields.emplace_back(name, end);
+      lookup.emplace(fields.back(), f);
+      name = end + 1;
+    }
+    values = reinterpret_cast<const real *>(names_end);
+  } catch (...) {
+    close();
+    throw;
+  }
+}
+
+void SampleStore::close() {
+#ifdef OSIRIS_HAVE_MMAP
+  if (data != nullptr and bytes > 0)
+    ::munmap(const_cast<char *>(data), bytes);
+#endif
+  data = nullptr;
+  values = nullptr;
+  bytes = 0;
+  buffer.clear();
+}
+
+SampleStore::~SampleStore() { close(); }
+
+SampleStore::SampleStore(SampleStore &&rhs) noexcept
+    : path(std::move(rhs.path)), data(std::exchange(rhs.data, nullptr)),
+      bytes(std::exchange(rhs.bytes, 0)), buffer(std::move(rhs.buffer)),
+      nsamples(std::exchange(rhs.nsamples, 0)), fields(std::move(rhs.fields)),
+      lookup(std::move(rhs.lookup)),
+      values(std::exchange(rhs.values, nullptr)) {}
+
+SampleStore &SampleStore::operator=(SampleStore &&rhs) noexcept {
+  if (this != &rhs) {
+    close();
+    path = std::move(rhs.path);
+    data = std::exchange(rhs.data, nullptr);
+    bytes = std::exchange(rhs.bytes, 0);
+    buffer = std::move(rhs.buffer);
+    nsamples = std::exchange(rhs.nsamples, 0);
+    fields = std::move(rhs.fields);
+    lookup = std::move(rhs.lookup);
+    values = std::exchange(rhs.values, nullptr);
+  }
+  return *this;
+}
+
+size_t SampleStore::index(const std::string &field) const {
+  const auto it = lookup.find(field);
+  if (it == lookup.end())
+    throw std::runtime_error("SampleStore: " + path + ": no field " + field);
+  return it->second;
+}
+
+bool SampleStore::Row::contains(const std::string &group) const {
+  const auto prefix = "/" + group + "/";
+  return std::any_of(store.fields.begin(), store.fields.end(),
+                     [&prefix](const std::string &field) {
+                       return field.compare(0, prefix.size(), prefix) == 0;
+                     });
+}
+
+json SampleStore::to_json(size_t sample) const {
+  assert(sample < nsamples);
+  auto flat = json::object();
+  for (size_t f = 0; f < fields.size(); ++f)
+    flat[fields[f]] = (*this)(sample, f);
+  return flat.unflatten();
+}
+
+void SampleStore::write(const std::string &path,
+                        const std::vector<json> &samples) {
+  const auto fail = [&path](const std::string &why) {
+    return std::runtime_error("SampleStore: " + path + ": " + why);
+  };
+
+  auto fields = std::vector<std::string>{};
+  if (not samples.empty()) {
+    const auto flat = samples.front().flatten();
+    for (const auto &[name, value] : flat.items()) {
+      if (not value.is_number())
+        throw fail("field " + name + " is not a number");
+      fields.push_back(name);
+    }
+  }
+
+  const auto n = samples.size();
+  auto values = std::vector<real>(fields.size() * n);
+  for (size_t s = 0; s < n; ++s) {
+    const auto flat = samples[s].flatten();
+    for (size_t f = 0; f < fields.size(); ++f) {
+      const auto it = flat.find(fields[f]);
+      if (it == flat.end() or not it->is_number())
+        throw fail("sample " + std::to_string(s) + " lacks field " +
+                   fields[f]);
+      values[f * n + s] = it->get<real>();
+    }
+  }
+
+  auto names = std::string{};
+  for (const auto &name : fields) {
+    names += name;
+    names += '\0';
+  }
+  names.resize((names.size() + 7) / 8 * 8, '\0');
+
+  auto out = std::ofstream(path, std::ios::binary | std::ios::trunc);
+  if (not out)
+    throw fail("can not open for writing");
+  out.write(magic, sizeof(magic));
+  write_u64(out, version);
+  write_u64(out, fields.size());
+  write_u64(out, n);
+  write_u64(out, names.size());
+  out.write(names.data(), static_cast<std::streamsize>(names.size()));
+  out.write(reinterpret_cast<const char *>(values.data()),
+            static_cast<std::streamsize>(values.size() * sizeof(real)));
+  if (not out)
+    throw fail("write failed");
+}
+
+void SampleStore::convert(const std::string &json_path,
+                          const std::string &out_path) {
+  auto in = std::ifstream(json_path);
+  if (not in)
+    throw std::runtime_error("SampleStore: can not open " + json_path);
+  const json j = json::parse(in);
+  if (j.is_array())
+    write(out_path, j.get<std::vector<json>>());
+  else
+    write(out_path, {j});
+}
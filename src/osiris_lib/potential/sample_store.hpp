@@ -0,0 +1,137 @@
+#ifndef SAMPLE_STORE_HEADER
+#define SAMPLE_STORE_HEADER
+
+#include "nlohmann/json.hpp"
+#include "util/types.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+using nlohmann::json;
+
+namespace osiris {
+
+/// @brief Read-only store of parameter posterior samples in a compact binary
+/// format, memory mapped so that opening it costs no parsing and no copies.
+/// Fields are the numeric leaves of the JSON parameter layout read by e.g.
+/// KD03Params(json), named by their JSON pointer such as
+/// "/KDHartreeFock/V1_0". The file, in native byte order, holds
+///   char[8]  magic "OSIRISPS"
+///   uint64   format version
+///   uint64   number of fields F
+///   uint64   number of samples N
+///   uint64   size of the name block in bytes, a multiple of 8
+///   char[]   F null-terminated field names, zero padded
+///   double[] F x N values, field-major, so each field is a contiguous column
+/// Write one from JSON samples with SampleStore::write or SampleStore::convert
+class SampleStore {
+private:
+  std::string path;
+  const char *data{};
+  size_t bytes{};
+  // fallback storage where mmap is not available
+  std::vector<char> buffer;
+
+  size_t nsamples{};
+  std::vector<std::string> fields;
+  std::unordered_map<std::string, size_t> lookup;
+  const real *values{};
+
+  void close();
+
+public:
+  static constexpr uint64_t version = 1;
+
+  /// @brief opens and memory maps the store at path
+  /// @throws std::runtime_error if the file is missing or not a valid store
+  explicit SampleStore(const std::string &path);
+  ~SampleStore();
+
+  SampleStore(const SampleStore &) = delete;
+  SampleStore &operator=(const SampleStore &) = delete;
+  SampleStore(SampleStore &&rhs) noexcept;
+  SampleStore &operator=(SampleStore &&rhs) noexcept;
+
+  /// @returns number of samples
+  size_t size() const { return nsamples; }
+  /// @returns field names, in the order of the columns
+  const std::vector<std::string> &names() const { return fields; }
+
+  /// @returns the column index of a field
+  /// @throws std::runtime_error if there is no such field
+  size_t index(const std::string &field) const;
+
+  /// @returns the size() values of a field, pointing into the mapped file
+  const real *column(size_t field) const { return values + field * nsamples; }
+  const real *column(const std::string &field) const {
+    return column(index(field));
+  }
+
+  /// @returns value of a field in a sample
+  real operator()(size_t sample, size_t field) const {
+    return column(field)[sample];
+  }
+
+  /// @brief A sample read with the nested keys of its JSON layout, e.g.
+  /// row["KDHartreeFock"]["V1_0"], straight from the columns, so that the
+  /// parameterizations read stores and JSON with the same code
+  class Row {
+  private:
+    const SampleStore &store;
+    size_t sample;
+
+  public:
+    struct Group {
+      const Row &row;
+      std::string prefix;
+
+      /// @throws std::runtime_error if the store has no such field
+      real operator[](const std::string &key) const {
+        return row.store(row.sample, row.store.index(prefix + key));
+      }
+    };
+
+    Row(const SampleStore &store, size_t sample)
+        : store(store), sample(sample) {}
+
+    Group operator[](const std::string &group) const {
+      return {*this, "/" + group + "/"};
+    }
+
+    /// @returns whether the store has any field in group
+    bool contains(const std::string &group) const;
+  };
+
+  Row row(size_t sample) const {
+    assert(sample < nsamples);
+    return Row(*this, sample);
+  }
+
+  /// @returns a sample in the JSON layout it was converted from
+  json to_json(size_t sample) const;
+
+  /// @returns a sample as a parameterization read straight from the columns,
+  /// e.g. sample<KD03Params<Proj::neutron>>(s), which equals
+  /// KD03Params<Proj::neutron>(to_json(s)) without building the JSON
+  template <class Params> Params sample(size_t s) const {
+    return Params(*this, s);
+  }
+
+  /// @brief writes samples in the JSON parameter layout to a store at path.
+  /// The fields are the numeric leaves of the first sample
+  /// @throws std::runtime_error if a sample lacks a field or the file can not
+  /// be written
+  static void write(const std::string &path, const std::vector<json> &samples);
+
+  /// @brief converts a JSON file holding either a single sample or an array
+  /// of samples to a store at out_path
+  static void convert(const std::string &json_path,
+                      const std::string &out_path);
+};
+
+} // namespace osiris
+
+#endif
@@ -0,0 +1,136 @@
+#include "potential/sample_stream.hpp"
+
+#include <stdexcept>
+#include <string>
+
+using namespace osiris;
+
+namespace {
+
+/// @brief SAX handler that builds the DOM of one sample at a time and hands
+/// it on as soon as its closing brace is read. Samples are the objects at the
+/// top level, or directly inside a top level array
+class SampleHandler : public nlohmann::json_sax<json> {
+private:
+  const std::function<void(json &&)> &emit;
+  json sample;
+  // open containers of the sample being read, innermost last
+  std::vector<json *> stack;
+  std::string current_key;
+  size_t depth = 0;
+  bool root_array = false;
+
+  static std::runtime_error fail(const std::string &why) {
+    return std::runtime_error("stream_samples: " + why);
+  }
+
+  json &open(json &&container) {
+    json &top = *stack.back();
+    if (top.is_object())
+      return top[current_key] = std::move(container);
+    top.push_back(std::move(container));
+    return top.back();
+  }
+
+  bool value(json &&v) {
+    if (stack.empty())
+      throw fail("samples must be objects");
+    open(std::move(v));
+    return true;
+  }
+
+public:
+  size_t count = 0;
+
+  explicit SampleHandler(const std::function<void(json &&)> &emit)
+      : emit(emit) {}
+
+  /// @brief reads the next document as a single sample
+  void reset() {
+    depth = 0;
+    root_array = false;
+  }
+
+  bool null() override { return value(nullptr); }
+  bool boolean(bool v) override { return value(v); }
+  bool number_integer(number_integer_t v) override { return value(v); }
+  bool number_unsigned(number_unsigned_t v) override { return value(v); }
+  bool number_float(number_float_t v, const string_t &) override {
+    return value(v);
+  }
+  bool string(string_t &v) override { return value(std::move(v)); }
+  bool binary(binary_t &v) override { return value(json::binary(v)); }
+
+  bool start_object(size_t) override {
+    if (stack.empty()) {
+      if (depth != (root_array ? 1 : 0))
+        throw fail("samples must be objects");
+      sample = json::object();
+      stack.push_back(&sample);
+    } else {
+      stack.push_back(&open(json::object()));
+    }
+    ++depth;
+    return true;
+  }
+
+  bool key(string_t &k) override {
+    current_key = std::move(k);
+    return true;
+  }
+
+  bool end_object() override {
+    --depth;
+    stack.pop_back();
+    if (stack.empty()) {
+      emit(std::move(sample));
+      ++count;
+    }
+    return true;
+  }
+
+  bool start_array(size_t) override {
+    if (stack.empty()) {
+      if (depth != 0)
+        throw fail("samples must be objects");
+      root_array = true;
+    } else {
+      stack.push_back(&open(json::array()));
+    }
+    ++depth;
+    return true;
+  }
+
+  bool end_array() override {
+    --depth;
+    if (not stack.empty())
+      stack.pop_back();
+    return true;
+  }
+
+  bool parse_error(size_t position, const std::string &,
+                   const nlohmann::detail::exception &e) override {
+    throw fail("parse error at byte " + std::to_string(position) + ": " +
+               e.what());
+  }
+};
+
+} // namespace
+
+size_t osiris::stream_samples(std::istream &in, SampleFormat format,
+                              const std::function<void(json &&)> &f) {
+  auto handler = SampleHandler(f);
+  if (format == SampleFormat::json) {
+    json::sax_parse(in, &handler);
+    return handler.count;
+  }
+
+  auto line = std::string{};
+  while (std::getline(in, line)) {
+    if (line.find_first_not_of(" \t\r") == std::string::npos)
+      continue;
+    handler.reset();
+    json::sax_parse(line, &handler);
+  }
+  return handler.count;
+}
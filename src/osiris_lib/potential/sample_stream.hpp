@@ -0,0 +1,198 @@
+#ifndef SAMPLE_STREAM_HEADER
+#define SAMPLE_STREAM_HEADER
+
+#include "nlohmann/json.hpp"
+#include "util/types.hpp"
+
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <istream>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+using nlohmann::json;
+
+namespace osiris {
+
+/// @brief Layout of a file of parameter samples, each an object in the JSON
+/// layout read by e.g. KD03Params(json) or WLH21Params(json)
+enum class SampleFormat : bool {
+  /// @brief a single sample, or an array of samples
+  json = 0,
+  /// @brief one sample per line
+  json_lines = 1
+};
+
+/// @brief Reads samples from in with a SAX parser, calling f with each
+/// sample as soon as it has been read. Only the sample being read is held in
+/// memory, so files far larger than memory can be streamed
+/// @returns number of samples read
+/// @throws std::runtime_error if the input is malformed, or isn't a sample
+/// or an array of samples; exceptions thrown by f propagate
+size_t stream_samples(std::istream &in, SampleFormat format,
+                      const std::function<void(json &&)> &f);
+
+/// @brief stream_samples, calling f with each sample constructed as Params,
+/// e.g. KD03Params<Proj::neutron>
+/// @returns number of samples read
+template <class Params, class F>
+size_t stream_params(std::istream &in, SampleFormat format, F f) {
+  return stream_samples(in, format,
+                        [&f](json &&sample) { f(Params(sample)); });
+}
+
+/// @brief stream_params, calling f with consecutive blocks of at most
+/// block_size parameter sets, e.g. to fill a KD03Ensemble block by block;
+/// only one block is held in memory
+/// @returns number of samples read
+template <class Params, class F>
+size_t stream_blocks(std::istream &in, SampleFormat format, size_t block_size,
+                     F f) {
+  assert(block_size > 0);
+  auto block = std::vector<Params>{};
+  block.reserve(block_size);
+  const auto n = stream_params<Params>(in, format, [&](Params &&params) {
+    block.push_back(std::move(params));
+    if (block.size() == block_size) {
+      f(std::move(block));
+      block.clear();
+      block.reserve(block_size);
+    }
+  });
+  if (not block.empty())
+    f(std::move(block));
+  return n;
+}
+
+namespace detail {
+
+/// @brief Multi-producer multi-consumer FIFO of at most capacity items.
+/// push blocks while the queue is full and pop while it is empty; after close
+/// pop drains the remaining items, after cancel both return immediately
+template <class T> class BoundedQueue {
+private:
+  std::mutex mutex;
+  std::condition_variable not_full, not_empty;
+  std::deque<T> items;
+  size_t capacity;
+  bool closed = false;
+  bool cancelled = false;
+
+public:
+  explicit BoundedQueue(size_t capacity) : capacity(capacity) {
+    assert(capacity > 0);
+  }
+
+  /// @returns false if the queue has been cancelled
+  bool push(T item) {
+    auto lock = std::unique_lock(mutex);
+    not_full.wait(lock,
+                  [this] { return items.size() < capacity or cancelled; });
+    if (cancelled)
+      return false;
+    items.push_back(std::move(item));
+    not_empty.notify_one();
+    return true;
+  }
+
+  /// @returns the next item, or nothing once the queue is closed and empty
+  /// or cancelled
+  std::optional<T> pop() {
+    auto lock = std::unique_lock(mutex);
+    not_empty.wait(lock,
+                   [this] { return not items.empty() or closed or cancelled; });
+    if (cancelled or items.empty())
+      return std::nullopt;
+    auto item = std::move(items.front());
+    items.pop_front();
+    not_full.notify_one();
+    return item;
+  }
+
+  /// @brief no more items will be pushed
+  void close() {
+    auto lock = std::unique_lock(mutex);
+    closed = true;
+    not_empty.notify_all();
+  }
+
+  /// @brief drop the remaining items and wake everyone up
+  void cancel() {
+    auto lock = std::unique_lock(mutex);
+    cancelled = true;
+    items.clear();
+    not_full.notify_all();
+    not_empty.notify_all();
+  }
+};
+
+/// @brief thrown from inside the parser to stop streaming early
+struct StreamCancelled {};
+
+} // namespace detail
+
+/// @brief Streams samples into a pool of nworkers threads while parsing
+/// continues. The parser hands each sample to a queue of at most capacity
+/// samples, so memory stays bounded when the workers are slower than the
+/// parser; the workers construct Params from it and call f(index, params),
+/// index being the position of the sample in the input. f is called
+/// concurrently and in no particular order. If f throws, streaming stops and
+/// the first exception is rethrown once all workers have finished
+/// @returns number of samples read
+template <class Params, class F>
+size_t stream_params_parallel(std::istream &in, SampleFormat format,
+                              size_t nworkers, size_t capacity, F f) {
+  assert(nworkers > 0);
+  auto queue = detail::BoundedQueue<std::pair<size_t, json>>(capacity);
+  auto error = std::exception_ptr{};
+  auto error_mutex = std::mutex{};
+  const auto fail = [&](std::exception_ptr e) {
+    {
+      auto lock = std::unique_lock(error_mutex);
+      if (not error)
+        error = e;
+    }
+    queue.cancel();
+  };
+
+  const auto work = [&]() {
+    while (auto item = queue.pop()) {
+      try {
+        f(item->first, Params(item->second));
+      } catch (...) {
+        fail(std::current_exception());
+      }
+    }
+  };
+  auto workers = std::vector<std::thread>{};
+  for (size_t w = 0; w < nworkers; ++w)
+    workers.emplace_back(work);
+
+  size_t n = 0;
+  try {
+    n = stream_samples(in, format, [&](json &&sample) {
+      if (not queue.push({n++, std::move(sample)}))
+        throw detail::StreamCancelled{};
+    });
+  } catch (const detail::StreamCancelled &) {
+  } catch (...) {
+    fail(std::current_exception());
+  }
+  queue.close();
+  for (auto &w : workers)
+    w.join();
+
+  if (error)
+    std::rethrow_exception(error);
+  return n;
+}
+
+} // namespace osiris
+
+#endif
@@ -1,79 +1,82 @@
 #include "potential/wlh_params.hpp"
 
+#include <string>
+
 using namespace osiris;
 
-WLH21Params<Proj::proton>::WLH21Params(json p) {
-  v0 = p["WLHReal"]["V0_p"];
-  v1 = p["WLHReal"]["V1_p"];
-  v2 = p["WLHReal"]["V2_p"];
-  v3 = p["WLHReal"]["V3_p"];
-  v4 = p["WLHReal"]["V4_p"];
-  v5 = p["WLHReal"]["V5_p"];
-  v6 = p["WLHReal"]["V6_p"];
-  r0 = p["WLHReal"]["r0_p"];
-  r1 = p["WLHReal"]["r1_p"];
-  r2 = p["WLHReal"]["r2_p"];
-  r3 = p["WLHReal"]["r3_p"];
-  a0 = p["WLHReal"]["a0_p"];
-  a1 = p["WLHReal"]["a1_p"];
-  a2 = p["WLHReal"]["a2_p"];
-  a3 = p["WLHReal"]["a3_p"];
-  a4 = p["WLHReal"]["a4_p"];
-  w0 = p["WLHImagVolume"]["W0_p"];
-  w1 = p["WLHImagVolume"]["W1_p"];
-  w2 = p["WLHImagVolume"]["W2_p"];
-  w3 = p["WLHImagVolume"]["W3_p"];
-  w4 = p["WLHImagVolume"]["W4_p"];
-  rw0 = p["WLHImagVolume"]["r0_p"];
-  rw1 = p["WLHImagVolume"]["r1_p"];
-  rw2 = p["WLHImagVolume"]["r2_p"];
-  rw3 = p["WLHImagVolume"]["r3_p"];
-  rw4 = p["WLHImagVolume"]["r4_p"];
-  rw5 = p["WLHImagVolume"]["r5_p"];
-  aw0 = p["WLHImagVolume"]["a0_p"];
-  aw1 = p["WLHImagVolume"]["a1_p"];
-  aw2 = p["WLHImagVolume"]["a2_p"];
-  aw3 = p["WLHImagVolume"]["a3_p"];
-  aw4 = p["WLHImagVolume"]["a4_p"];
-  d0 = p["WLHImagSurface"]["W0_p"];
-  d1 = p["WLHImagSurface"]["W1_p"];
-  d2 = p["WLHImagSurface"]["W2_p"];
-  d3 = p["WLHImagSurface"]["W3_p"];
-  rs0 = p["WLHImagSurface"]["r0_p"];
-  rs1 = p["WLHImagSurface"]["r1_p"];
-  rs2 = p["WLHImagSurface"]["r2_p"];
-  as0 = p["WLHImagSurface"]["a0_p"];
-  vso_0 = p["WLHRealSpinOrbit"]["V0_p"];
-  vso_1 = p["WLHRealSpinOrbit"]["V1_p"];
-  rso_0 = p["WLHRealSpinOrbit"]["r0_p"];
-  rso_1 = p["WLHRealSpinOrbit"]["r1_p"];
-  aso_0 = p["WLHRealSpinOrbit"]["a0_p"];
-  aso_1 = p["WLHRealSpinOrbit"]["a1_p"];
+namespace {
+
+/// @brief reads WLH21 parameters from p["group"]["key" + suffix], p being a
+/// JSON object or a SampleStore::Row, and suffix "_n" or "_p"
+template <class Sample>
+void read(WLH21Params<Proj::neutron> &w, Sample &&p,
+          const std::string &suffix) {
+  w.v0 = p["WLHReal"]["V0" + suffix];
+  w.v1 = p["WLHReal"]["V1" + suffix];
+  w.v2 = p["WLHReal"]["V2" + suffix];
+  w.v3 = p["WLHReal"]["V3" + suffix];
+  w.v4 = p["WLHReal"]["V4" + suffix];
+  w.v5 = p["WLHReal"]["V5" + suffix];
+  w.v6 = p["WLHReal"]["V6" + suffix];
+  w.r0 = p["WLHReal"]["r0" + suffix];
+  w.r1 = p["WLHReal"]["r1" + suffix];
+  w.r2 = p["WLHReal"]["r2" + suffix];
+  w.r3 = p["WLHReal"]["r3" + suffix];
+  w.a0 = p["WLHReal"]["a0" + suffix];
+  w.a1 = p["WLHReal"]["a1" + suffix];
+  w.a2 = p["WLHReal"]["a2" + suffix];
+  w.a3 = p["WLHReal"]["a3" + suffix];
+  w.a4 = p["WLHReal"]["a4" + suffix];
+  w.w0 = p["WLHImagVolume"]["W0" + suffix];
+  w.w1 = p["WLHImagVolume"]["W1" + suffix];
+  w.w2 = p["WLHImagVolume"]["W2" + suffix];
+  w.w3 = p["WLHImagVolume"]["W3" + suffix];
+  w.w4 = p["WLHImagVolume"]["W4" + suffix];
+  w.rw0 = p["WLHImagVolume"]["r0" + suffix];
+  w.rw1 = p["WLHImagVolume"]["r1" + suffix];
+  w.rw2 = p["WLHImagVolume"]["r2" + suffix];
+  w.rw3 = p["WLHImagVolume"]["r3" + suffix];
+  w.rw4 = p["WLHImagVolume"]["r4" + suffix];
+  w.rw5 = p["WLHImagVolume"]["r5" + suffix];
+  w.aw0 = p["WLHImagVolume"]["a0" + suffix];
+  w.aw1 = p["WLHImagVolume"]["a1" + suffix];
+  w.aw2 = p["WLHImagVolume"]["a2" + suffix];
+  w.aw3 = p["WLHImagVolume"]["a3" + suffix];
+  w.aw4 = p["WLHImagVolume"]["a4" + suffix];
+  w.d0 = p["WLHImagSurface"]["W0" + suffix];
+  w.d1 = p["WLHImagSurface"]["W1" + suffix];
+  w.d2 = p["WLHImagSurface"]["W2" + suffix];
+  w.d3 = p["WLHImagSurface"]["W3" + suffix];
+  w.rs0 = p["WLHImagSurface"]["r0" + suffix];
+  w.rs1 = p["WLHImagSurface"]["r1" + suffix];
+  w.rs2 = p["WLHImagSurface"]["r2" + suffix];
+  w.as0 = p["WLHImagSurface"]["a0" + suffix];
+  w.vso_0 = p["WLHRealSpinOrbit"]["V0" + suffix];
+  w.vso_1 = p["WLHRealSpinOrbit"]["V1" + suffix];
+  w.rso_0 = p["WLHRealSpinOrbit"]["r0" + suffix];
+  w.rso_1 = p["WLHRealSpinOrbit"]["r1" + suffix];
+  w.aso_0 = p["WLHRealSpinOrbit"]["a0" + suffix];
+  w.aso_1 = p["WLHRealSpinOrbit"]["a1" + suffix];
+}
+
+} // namespace
+
+WLH21Params<Proj::proton>::WLH21Params(json p) { read(*this, p, "_p"); }
+
+WLH21Params<Proj::proton>::WLH21Params(const SampleStore &store,
+                                       size_t sample) {
+  read(*this, store.row(sample), "_p");
+}
+
+template <> WLH21Params<Proj::neutron>::WLH21Params(json p) {
+  read(*this, p, "_n");
 }
 
 template <>
-WLH21Params<Proj::neutron>::WLH21Params(json p)
-    : v0(p["WLHReal"]["V0_n"]), v1(p["WLHReal"]["V1_n"]), v2(p["WLHReal"]["V2_n"]),
-      v3(p["WLHReal"]["V3_n"]), v4(p["WLHReal"]["V4_n"]), v5(p["WLHReal"]["V5_n"]),
-      v6(p["WLHReal"]["V6_n"]), r0(p["WLHReal"]["r0_n"]), r1(p["WLHReal"]["r1_n"]),
-      r2(p["WLHReal"]["r2_n"]), r3(p["WLHReal"]["r3_n"]), a0(p["WLHReal"]["a0_n"]),
-      a1(p["WLHReal"]["a1_n"]), a2(p["WLHReal"]["a2_n"]), a3(p["WLHReal"]["a3_n"]),
-      a4(p["WLHReal"]["a4_n"]), w0(p["WLHImagVolume"]["W0_n"]),
-      w1(p["WLHImagVolume"]["W1_n"]), w2(p["WLHImagVolume"]["W2_n"]),
-      w3(p["WLHImagVolume"]["W3_n"]), w4(p["WLHImagVolume"]["W4_n"]),
-      rw0(p["WLHImagVolume"]["r0_n"]), rw1(p["WLHImagVolume"]["r1_n"]),
-      rw2(p["WLHImagVolume"]["r2_n"]), rw3(p["WLHImagVolume"]["r3_n"]),
-      rw4(p["WLHImagVolume"]["r4_n"]), rw5(p["WLHImagVolume"]["r5_n"]),
-      aw0(p["WLHImagVolume"]["a0_n"]), aw1(p["WLHImagVolume"]["a1_n"]),
-      aw2(p["WLHImagVolume"]["a2_n"]), aw3(p["WLHImagVolume"]["a3_n"]),
-      aw4(p["WLHImagVolume"]["a4_n"]), d0(p["WLHImagSurface"]["W0_n"]),
-      d1(p["WLHImagSurface"]["W1_n"]), d2(p["WLHImagSurface"]["W2_n"]),
-      d3(p["WLHImagSurface"]["W3_n"]), rs0(p["WLHImagSurface"]["r0_n"]),
-      rs1(p["WLHImagSurface"]["r1_n"]), rs2(p["WLHImagSurface"]["r2_n"]),
-      as0(p["WLHImagSurface"]["a0_n"]), vso_0(p["WLHRealSpinOrbit"]["V0_n"]),
-      vso_1(p["WLHRealSpinOrbit"]["V1_n"]), rso_0(p["WLHRealSpinOrbit"]["r0_n"]),
-      rso_1(p["WLHRealSpinOrbit"]["r1_n"]), aso_0(p["WLHRealSpinOrbit"]["a0_n"]),
-      aso_1(p["WLHRealSpinOrbit"]["a1_n"]) {}
+WLH21Params<Proj::neutron>::WLH21Params(const SampleStore &store,
+                                        size_t sample) {
+  read(*this, store.row(sample), "_n");
+}
 
 WLH21Params<Proj::proton>::WLH21Params()
     : WLH21Params<Proj::neutron>(), OMParams<Proj::proton>() {
@@ -124,3 +127,11 @@ WLH21Params<Proj::proton>::WLH21Params()
   aso_0 = 0.8032951951;
   aso_1 = 0.0003508356;
 }
+
+WLH21Params<Proj::proton>::Bound
+osiris::WLH21Params<Proj::proton>::bind(int Z, int A) const {
+  const real a = static_cast<real>(A);
+  return {{WLH21Params<Proj::neutron>::bind(Z, A)},
+          real_coul_V_outer(Z, A, 0),
+          real_coul_r(Z, A, 0) * pow(a, 1. / 3.)};
+}
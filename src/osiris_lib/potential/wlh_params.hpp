@@ -2,6 +2,7 @@
 #define WLH_PARAMS_HEADER
 
 #include "potential/params_base.hpp"
+#include "potential/sample_store.hpp"
 #include "util/constants.hpp"
 #include "util/types.hpp"
 
@@ -66,6 +67,9 @@ public:
   real cmpl_spin_r(int, int, real) const final { return 0; }
 
   WLH21Params(json p);
+  /// @brief construct from a sample of a store in the JSON layout, reading
+  /// its columns directly
+  WLH21Params(const SampleStore &store, size_t sample);
   WLH21Params()
       : v0(52.6912521913), v1(0.2849592984), v2(-0.0002654968), v3(2.6234e-06),
         v4(21.0895801061), v5(0.2847889774), v6(0.0010745253), r0(1.2978610209),
@@ -82,16 +86,83 @@ public:
         rso_0(1.2794000707), rso_1(0.8734769907), aso_0(0.8060570111),
         aso_1(0.0003509748) {}
 
+  /// @brief WLH21 bound to a single target. The A- and Z-dependent factors,
+  /// A^(1/3) and the asymmetry, are computed once by bind, so each energy only
+  /// costs the energy polynomials. Accessors take the energy alone and return
+  /// exactly what the accessors of the parameters it was bound from return for
+  /// that target. Holds a pointer to those parameters, which must outlive it
+  class Bound {
+  private:
+    friend class WLH21Params<projectile>;
+
+    const WLH21Params<projectile> *p;
+    real a, a13;
+    // +(N-Z)/A, and the sign convention of OMParams<projectile>::asym
+    real delta, delta_proj;
+    real rw_num, rw_den, a_asym;
+    real rso, aso, vso;
+
+  public:
+    static constexpr bool charged = false;
+
+    real real_cent_r(real erg) const {
+      return (p->r0 - p->r1 * erg + p->r2 * erg * erg) * a13 - p->r3;
+    }
+    real cmpl_cent_r(real erg) const {
+      return a13 * (p->rw0 + rw_num / (rw_den + p->rw4 * erg) +
+                   p->rw5 * erg * erg);
+    }
+    real real_surf_r(real) const { return 0; }
+    real cmpl_surf_r(real erg) const {
+      return a13 * (p->rs0 - p->rs2 * erg) - p->rs1;
+    }
+    real real_spin_r(real) const { return rso; }
+    real cmpl_spin_r(real) const { return 0; }
+
+    real real_cent_a(real erg) const;
+    real cmpl_cent_a(real erg) const {
+      return p->aw0 + p->aw1 * erg / (p->aw2 + erg) +
+             (p->aw3 - p->aw4 * erg) * delta;
+    }
+    real real_surf_a(real) const { return 0; }
+    real cmpl_surf_a(real) const { return p->as0; }
+    real real_spin_a(real) const { return aso; }
+    real cmpl_spin_a(real) const { return 0; }
+
+    real real_cent_V(real erg) const;
+    real cmpl_cent_V(real erg) const;
+    real real_surf_V(real) const { return 0; }
+    real cmpl_surf_V(real erg) const;
+    real real_spin_V(real) const { return vso; }
+    real cmpl_spin_V(real) const { return 0; }
+  };
+
+  /// @returns these parameters bound to the target Z, A
+  Bound bind(int Z, int A) const;
 };
 
 template <>
 class WLH21Params<Proj::proton> : public WLH21Params<Proj::neutron>,
-                                  OMParams<Proj::proton> {
+                                  public OMParams<Proj::proton> {
 public:
   // TODO what is the Coulomb contribution to WLH
   real real_coul_r(int, int, real) const final { return 0; }
   WLH21Params(json p);
+  WLH21Params(const SampleStore &store, size_t sample);
   WLH21Params();
+
+  /// @brief WLH21Params<Proj::neutron>::Bound plus the energy-independent
+  /// Coulomb term of get_coulomb_term
+  struct Bound : WLH21Params<Proj::neutron>::Bound {
+    static constexpr bool charged = true;
+    /// @brief Z e^2 [MeV fm]
+    real coul_q2;
+    /// @brief radius of the uniformly charged sphere [fm]
+    real coul_R;
+  };
+
+  /// @returns these parameters bound to the target Z, A
+  Bound bind(int Z, int A) const;
 };
 
 template <Proj proj>
@@ -189,6 +260,64 @@ real WLH21Params<proj>::real_spin_V(int, int A, real) const {
   return constants::csp * (vso_0 - vso_1 * static_cast<real>(A));
 }
 
+template <Proj proj>
+typename WLH21Params<proj>::Bound WLH21Params<proj>::bind(int Z,
+                                                        int A) const {
+  auto b = Bound{};
+  b.p = this;
+  b.a = static_cast<real>(A);
+  b.a13 = pow(b.a, 1. / 3.);
+  b.delta = OMParams<Proj::proton>::asym(Z, A);
+  b.delta_proj = OMParams<proj>::asym(Z, A);
+  b.rw_num = rw1 + rw2 * b.a;
+  b.rw_den = rw3 + b.a;
+  b.a_asym = (a3 - a4 * b.delta) * b.delta;
+  b.rso = rso_0 * b.a13 - rso_1;
+  b.aso = aso_0 - aso_1 * b.a;
+  b.vso = constants::csp * (vso_0 - vso_1 * b.a);
+  return b;
+}
+
+template <Proj proj>
+real WLH21Params<proj>::Bound::real_cent_a(real erg) const {
+  const real a_np = p->a0 - p->a2 * erg * erg - a_asym;
+  if constexpr (proj == Proj::neutron)
+    return a_np + p->a1 * erg;
+  if constexpr (proj == Proj::proton)
+    return a_np - p->a1 * erg;
+}
+
+template <Proj proj>
+real WLH21Params<proj>::Bound::real_cent_V(real erg) const {
+  const real v_erg =
+      p->v0 - p->v1 * erg + p->v2 * erg * erg + p->v3 * erg * erg * erg;
+  const real v_asym = (p->v4 - p->v5 * erg + p->v6 * erg * erg) * delta_proj;
+  return -(v_erg + v_asym);
+}
+
+template <Proj proj>
+real WLH21Params<proj>::Bound::cmpl_cent_V(real erg) const {
+  const real v_erg = p->w0 + p->w1 * erg - p->w2 * erg * erg;
+  if constexpr (proj == Proj::neutron)
+    return -(v_erg + (-p->w3 - p->w4 * erg) * delta);
+  if constexpr (proj == Proj::proton)
+    return -(v_erg + (+p->w3 - p->w4 * erg) * delta);
+}
+
+template <Proj proj>
+real WLH21Params<proj>::Bound::cmpl_surf_V(real erg) const {
+  if constexpr (proj == Proj::proton) {
+    if (erg > 20)
+      return 0;
+  }
+  if constexpr (proj == Proj::neutron) {
+    if (erg > 40)
+      return 0;
+  }
+  return 4 * p->as0 *
+         (p->d0 - p->d1 * erg - (p->d2 - p->d3 * erg) * delta);
+}
+
 } // namespace osiris
 
 #endif
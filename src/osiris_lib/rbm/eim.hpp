@@ -63,18 +63,15 @@ public:
   array1d_t coefficients(params_t alpha, int l) const {
     auto Ainv = xt::strided_view(Ainv_matrices, {l, xt::ellipsis()});
     auto u_real = array1d_t({nbasis});
-    for (int i = 0; i < nbasis; ++i)
-      u_real(i) = tilde(r_matches(i), alpha, l);
+    eval_potential(alpha, l, &u_real(0));
     return xt::linalg::dot(Ainv, u_real);
   }
 
   array2d_t coefficients(params_t alpha) const {
     auto Ainv = Ainv_matrices;
     auto u_real = array2d_t({lmax, nbasis});
-    for (int l = 0; l < lmax; ++l) {
-      for (int i = 0; i < nbasis; ++i)
-        u_real(l, i) = tilde(r_matches(i), alpha, l);
-    }
+    for (int l = 0; l < lmax; ++l)
+      eval_potential(alpha, l, &u_real(l, 0));
     return xt::linalg::tensordot(Ainv, u_real, 1);
   }
 
@@ -91,9 +88,23 @@ private:
     const auto k = momentum(alpha);
     const auto energy = E(alpha);
     const auto r = s / k;
-    return potentials(l)->operator()(r, xt::view(alpha, xt::range(2, _))) /
+    return potentials[l]->operator()(r, xt::view(alpha, xt::range(2, _))) /
            energy;
   }
+
+  /// @brief tilde at every matching point, out[i] for i < nbasis, with one
+  /// batched call into the potential
+  void eval_potential(params_t alpha, int l, cmpl *out) const {
+    const auto k = momentum(alpha);
+    const auto energy = E(alpha);
+    auto r = std::vector<real>(nbasis);
+    for (int i = 0; i < nbasis; ++i)
+      r[i] = std::real(r_matches(i)) / k;
+    const params_t params = xt::view(alpha, xt::range(2, _));
+    potentials[l]->batch(r.data(), r.size(), params, out);
+    for (int i = 0; i < nbasis; ++i)
+      out[i] /= energy;
+  }
 };
 } // namespace osiris
 
@@ -0,0 +1,117 @@
+#ifndef ASYMPTOTICS_CACHE_HEADER
+#define ASYMPTOTICS_CACHE_HEADER
+
+#include "solver/channel.hpp"
+#include "util/config.hpp"
+#include "util/types.hpp"
+
+#include "xtensor/xtensor.hpp"
+
+#include <cassert>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+namespace osiris {
+
+/// @brief Thread-safe cache of the (lmax, 4) asymptotic tables of
+/// Channel::Asymptotics::generate_asymptotics, keyed on s = k * radius, the
+/// Sommerfeld parameter and lmax. Keys compare exactly, which is what repeated
+/// queries on the same channel radius and energy grid produce. The cache holds
+/// at most capacity tables and evicts the least recently used one, so sweeps
+/// over continuous energies or radii do not grow it without bound. A miss
+/// builds the table outside the lock and the first insert wins. Tables are
+/// handed out as shared pointers, so they stay valid after eviction or
+/// clear(). There is no process-wide instance: callers that revisit the same
+/// energies own a cache and pass it in, e.g. to RMatrixKernel::partial_waves
+class AsymptoticsCache {
+public:
+  using Table = xt::xtensor<cmpl, 2>;
+
+private:
+  using Key = std::tuple<real, real, int>;
+  struct Entry {
+    std::shared_ptr<const Table> table;
+    // position in recency, most recent first
+    std::list<Key>::iterator use;
+  };
+
+  mutable std::mutex mutex;
+  size_t capacity;
+  std::map<Key, Entry> tables;
+  std::list<Key> recency;
+
+public:
+  explicit AsymptoticsCache(size_t capacity = 1024) : capacity(capacity) {
+    assert(capacity > 0);
+  }
+
+  /// @returns (lmax, 4) table of H+, H-, H+', H-' at s for l = 0..lmax-1
+  std::shared_ptr<const Table> operator()(int lmax, real s, real eta = 0.) {
+    assert(lmax > 0 and lmax <= MAXL);
+    const auto key = Key{s, eta, lmax};
+    {
+      std::unique_lock lock(mutex);
+      const auto it = tables.find(key);
+      if (it != tables.end()) {
+        recency.splice(recency.begin(), recency, it->second.use);
+        return it->second.table;
+      }
+    }
+    auto table = std::make_shared<const Table>(
+        Channel::Asymptotics::generate_asymptotics(lmax, s, eta));
+    std::unique_lock lock(mutex);
+    const auto [it, inserted] = tables.try_emplace(key, Entry{table, {}});
+    if (not inserted) {
+      recency.splice(recency.begin(), recency, it->second.use);
+      return it->second.table;
+    }
+    recency.push_front(key);
+    it->second.use = recency.begin();
+    if (tables.size() > capacity) {
+      tables.erase(recency.back());
+      recency.pop_back();
+    }
+    return table;
+  }
+
+  /// @returns asymptotics of partial wave am.l at the radius of ch, from the
+  /// cached table of l = 0..lmax-1
+  Channel::Asymptotics operator()(const Channel &ch,
+                                  const Channel::Energetics &e,
+                                  const Channel::FermionSpinOrbitCoupling &am,
+                                  int lmax = MAXL) {
+    assert(am.l < lmax);
+    const auto table = operator()(lmax, e.k * ch.radius, e.sommerfield_param);
+    return row(*table, am.l);
+  }
+
+  /// @returns asymptotics of partial wave l from a table
+  static Channel::Asymptotics row(const Table &table, int l) {
+    auto asym = Channel::Asymptotics{};
+    asym.wvfxn_out = table(l, 0);
+    asym.wvfxn_in = table(l, 1);
+    asym.wvfxn_deriv_out = table(l, 2);
+    asym.wvfxn_deriv_in = table(l, 3);
+    return asym;
+  }
+
+  size_t size() const {
+    std::unique_lock lock(mutex);
+    return tables.size();
+  }
+
+  size_t max_size() const { return capacity; }
+
+  void clear() {
+    std::unique_lock lock(mutex);
+    tables.clear();
+    recency.clear();
+  }
+};
+
+} // namespace osiris
+
+#endif
@@ -2,6 +2,7 @@
 #define CHANNEL_HEADER
 
 #include "util/asymptotics.hpp"
+#include "util/config.hpp"
 #include "util/constants.hpp"
 #include "util/types.hpp"
 
@@ -68,7 +69,7 @@ struct Channel {
       auto couplings = xt::xtensor<real, 1>(std::array<size_t, 1>{size});
       auto i = couplings.begin();
       for (; l < lmax; ++l) {
-        auto j21 = 2 * l + 2;
+        auto j21 = p == Polarization::up ? 2 * l + 2 : 2 * l;
         auto coupling = FermionSpinOrbitCoupling(j21, l);
         *i = coupling.l_dot_s();
         ++i;
@@ -98,7 +99,7 @@ struct Channel {
 
     Energetics(real erg_cms, const Channel &ch)
         : erg_cms(erg_cms - ch.threshold),
-          erg_lab(erg_cms *
+          erg_lab(this->erg_cms *
                   (ch.proj_mass * constants::MeV_per_amu +
                    ch.targ_mass * constants::MeV_per_amu) /
                   (ch.targ_mass * constants::MeV_per_amu)),
@@ -114,7 +115,7 @@ struct Channel {
             return m2 * sqrt(erg_lab * (erg_lab + 2 * m1)) /
                    sqrt((m1 + m2) * (m1 + m2) + 2 * m2 * erg_lab) / (hbar * c);
           }()),
-          reduced_mass([&erg_cms, &ch, this]() -> real {
+          reduced_mass([&ch, this]() -> real {
             using constants::hbar;
             using constants::c;
             using constants::MeV_per_amu;
@@ -122,7 +123,7 @@ struct Channel {
             // relativistic-corrected reduced mass [MeV]
             // Eq. 21 of Ingemarsson, 1974
             const auto m1 = ch.proj_mass * MeV_per_amu;
-            const auto Ep = m1 + erg_cms;
+            const auto Ep = m1 + this->erg_cms;
 
             return hbar * hbar * c * c * k * k * Ep / (Ep * Ep - m1 * m1);
           }()),
@@ -163,15 +164,31 @@ struct Channel {
 
     Asymptotics(int l, real k, real r) : Asymptotics(l, k * r) {}
 
-    Asymptotics(int l, real s)
-        : wvfxn_out(asymptotics::h_plus{l}(s)),
-          wvfxn_in(asymptotics::h_minus{l}(s)),
-          wvfxn_deriv_out(asymptotics::d_dz(asymptotics::h_plus{l})(s)),
-          wvfxn_deriv_in(asymptotics::d_dz(asymptotics::h_minus{l})(s)) {}
+    Asymptotics(int l, real s) : Asymptotics(neutral(l, s)) {}
+
+    /// @brief picks partial wave l out of a batched evaluation
+    /// @tparam Functions asymptotics::RiccatiBessel or asymptotics::Coulomb
+    template <class Functions>
+    Asymptotics(const Functions &fns, int l)
+        : wvfxn_out(fns.h_plus(l)), wvfxn_in(fns.h_minus(l)),
+          wvfxn_deriv_out(fns.h_plus_deriv(l)),
+          wvfxn_deriv_in(fns.h_minus_deriv(l)) {}
+
+    /// @returns Coulomb asymptotics for Sommerfeld parameter eta, or the
+    /// neutral ones for eta = 0. The Coulomb phase sigma_l is not included,
+    /// so S-matrices built from these are relative to pure Coulomb scattering
+    static Asymptotics coulomb(int l, real s, real eta) {
+      if (eta == 0.)
+        return Asymptotics(l, s);
+      return Asymptotics(asymptotics::Coulomb(l + 1, eta, s), l);
+    }
 
     static xt::xtensor<cmpl, 2> generate_asymptotics(const int lmax,
                                                      const real s) {
       assert(lmax > 0);
+      if (lmax <= MAXL)
+        return generate_asymptotics(asymptotics::RiccatiBessel(lmax, s),
+                                    lmax);
       auto asym = xt::xtensor<cmpl, 2>({(size_t)lmax, 4});
       for (int l = 0; l < lmax; ++l) {
         const auto [h_plus, h_minus, h_plus_prime, h_minus_prime] =
@@ -183,6 +200,47 @@ struct Channel {
       }
       return asym;
     }
+
+    /// @returns (lmax, 4) table of neutral or Coulomb asymptotics, according
+    /// to the Sommerfeld parameter eta
+    static xt::xtensor<cmpl, 2> generate_asymptotics(const int lmax,
+                                                     const real s,
+                                                     const real eta) {
+      assert(lmax > 0);
+      if (eta == 0.)
+        return generate_asymptotics(lmax, s);
+      return generate_asymptotics(asymptotics::Coulomb(lmax, eta, s), lmax);
+    }
+
+  private:
+    /// @returns neutral asymptotics of partial wave l, by recurrence for
+    /// l < MAXL, and from the library spherical Bessel functions beyond the
+    /// storage of asymptotics::RiccatiBessel
+    static Asymptotics neutral(int l, real s) {
+      if (l < MAXL)
+        return Asymptotics(asymptotics::RiccatiBessel(l + 1, s), l);
+      auto a = Asymptotics{};
+      a.wvfxn_out = asymptotics::h_plus{l}(s);
+      a.wvfxn_in = asymptotics::h_minus{l}(s);
+      a.wvfxn_deriv_out = asymptotics::d_dz(asymptotics::h_plus{l})(s);
+      a.wvfxn_deriv_in = asymptotics::d_dz(asymptotics::h_minus{l})(s);
+      return a;
+    }
+
+    template <class Functions>
+    static xt::xtensor<cmpl, 2> generate_asymptotics(const Functions &fns,
+                                                     const int lmax) {
+      auto asym = xt::xtensor<cmpl, 2>({(size_t)lmax, 4});
+      for (int l = 0; l < lmax; ++l) {
+        const auto [h_plus, h_minus, h_plus_prime, h_minus_prime] =
+            Asymptotics(fns, l);
+        asym(l, 0) = h_plus;
+        asym(l, 1) = h_minus;
+        asym(l, 2) = h_plus_prime;
+        asym(l, 3) = h_minus_prime;
+      }
+      return asym;
+    }
   };
 
   /// @brief channel energy threshold [MeV]
@@ -213,6 +271,13 @@ struct Channel {
     return Asymptotics(am.l, k, radius);
   }
 
+  /// @returns neutral or Coulomb asymptotics, according to the Sommerfeld
+  /// parameter of e
+  Asymptotics set_angular_momentum(FermionSpinOrbitCoupling am,
+                                   const Energetics &e) const {
+    return Asymptotics::coulomb(am.l, e.k * radius, e.sommerfield_param);
+  }
+
   /// @param threshold [Mev]
   /// @param radius [fm]
   /// @param proj_mass [amu]
@@ -0,0 +1,50 @@
+#include "solver/factorization.hpp"
+
+#include <algorithm>
+#include <map>
+#include <type_traits>
+#include <vector>
+
+extern "C" {
+void zsytrf_(const char *uplo, const int *n, std::complex<double> *a,
+             const int *lda, int *ipiv, std::complex<double> *work,
+             const int *lwork, int *info);
+void zsytrs_(const char *uplo, const int *n, const int *nrhs,
+             const std::complex<double> *a, const int *lda, const int *ipiv,
+             std::complex<double> *b, const int *ldb, int *info);
+}
+
+namespace osiris::detail {
+
+int lapack_zsytrf(cmpl *a, int *ipiv, int n) {
+  static_assert(std::is_same_v<cmpl, std::complex<double>>);
+  const char uplo = 'L';
+  int info = 0;
+
+  // optimal workspace sizes by n, and a workspace that only ever grows
+  thread_local std::map<int, int> lworks;
+  thread_local std::vector<cmpl> work;
+
+  auto it = lworks.find(n);
+  if (it == lworks.end()) {
+    int query_lwork = -1;
+    cmpl query = 0;
+    zsytrf_(&uplo, &n, a, &n, ipiv, &query, &query_lwork, &info);
+    it = lworks.emplace(n, std::max(1, static_cast<int>(query.real()))).first;
+  }
+  int lwork = it->second;
+  if (work.size() < static_cast<size_t>(lwork))
+    work.resize(static_cast<size_t>(lwork));
+
+  zsytrf_(&uplo, &n, a, &n, ipiv, work.data(), &lwork, &info);
+  return info;
+}
+
+int lapack_zsytrs(const cmpl *a, const int *ipiv, int n, cmpl *b, int nrhs) {
+  const char uplo = 'L';
+  int info = 0;
+  zsytrs_(&uplo, &n, &nrhs, a, &n, ipiv, b, &n, &info);
+  return info;
+}
+
+} // namespace osiris::detail
@@ -0,0 +1,349 @@
+#ifndef FACTORIZATION_HEADER
+#define FACTORIZATION_HEADER
+
+#include "util/types.hpp"
+
+#include "xtensor/xtensor.hpp"
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace osiris {
+
+/// @brief Dense factorizations available for the Lagrange-mesh linear systems.
+/// Optical model mesh matrices are complex symmetric (not Hermitian), so the
+/// symmetric-indefinite LDL^T factorization needs about half the flops and
+/// memory of a general LU
+enum class Factorization : bool { lu = 0, symmetric = 1 };
+
+namespace detail {
+
+inline real cabs1(cmpl z) { return fabs(z.real()) + fabs(z.imag()); }
+
+/// @brief In-place Bunch-Kaufman factorization A = L D L^T of an n x n complex
+/// symmetric matrix, stored column-major with only the lower triangle
+/// referenced, following the unblocked algorithm of LAPACK zsytf2. D is block
+/// diagonal with 1x1 and 2x2 blocks. Pivots use the LAPACK convention (0-based):
+/// ipiv[k] >= 0 is a 1x1 block with rows k and ipiv[k] interchanged, while
+/// ipiv[k] = ipiv[k+1] = -(p+1) is a 2x2 block with rows k+1 and p interchanged
+/// @returns false if the matrix is exactly singular
+inline bool bunch_kaufman_factor(cmpl *a, int *ipiv, size_t n) {
+  const auto A = [a, n](size_t i, size_t j) -> cmpl & { return a[i + j * n]; };
+  const real alpha = (1. + sqrt(17.)) / 8.;
+
+  size_t k = 0;
+  while (k < n) {
+    size_t kstep = 1;
+    size_t kp = k;
+    const auto absakk = cabs1(A(k, k));
+
+    size_t imax = k;
+    real colmax = 0;
+    for (size_t i = k + 1; i < n; ++i) {
+      if (cabs1(A(i, k)) > colmax) {
+        colmax = cabs1(A(i, k));
+        imax = i;
+      }
+    }
+
+    if (std::max(absakk, colmax) == 0.)
+      return false;
+
+    if (absakk < alpha * colmax) {
+      real rowmax = 0;
+      for (size_t j = k; j < imax; ++j)
+        rowmax = std::max(rowmax, cabs1(A(imax, j)));
+      for (size_t j = imax + 1; j < n; ++j)
+        rowmax = std::max(rowmax, cabs1(A(j, imax)));
+
+      if (absakk >= alpha * colmax * (colmax / rowmax)) {
+        kp = k;
+      } else if (cabs1(A(imax, imax)) >= alpha * rowmax) {
+        kp = imax;
+      } else {
+        kp = imax;
+        kstep = 2;
+      }
+    }
+
+    // interchange rows and columns kk and kp of the trailing submatrix
+    const auto kk = k + kstep - 1;
+    if (kp != kk) {
+      for (size_t i = kp + 1; i < n; ++i)
+        std::swap(A(i, kk), A(i, kp));
+      for (size_t j = kk + 1; j < kp; ++j)
+        std::swap(A(j, kk), A(kp, j));
+      std::swap(A(kk, kk), A(kp, kp));
+      if (kstep == 2)
+        std::swap(A(k + 1, k), A(kp, k));
+    }
+
+    if (kstep == 1) {
+      // rank-1 update of the trailing submatrix, then store L(k+1:n, k)
+      const cmpl d11 = 1. / A(k, k);
+      for (size_t j = k + 1; j < n; ++j) {
+        const cmpl ajk = d11 * A(j, k);
+        for (size_t i = j; i < n; ++i)
+          A(i, j) -= ajk * A(i, k);
+      }
+      for (size_t i = k + 1; i < n; ++i)
+        A(i, k) *= d11;
+      ipiv[k] = static_cast<int>(kp);
+    } else {
+      // rank-2 update of the trailing submatrix, then store L(k+2:n, k:k+1)
+      if (k + 2 < n) {
+        cmpl d21 = A(k + 1, k);
+        const cmpl d11 = A(k + 1, k + 1) / d21;
+        const cmpl d22 = A(k, k) / d21;
+        const cmpl t = 1. / (d11 * d22 - 1.);
+        d21 = t / d21;
+        for (size_t j = k + 2; j < n; ++j) {
+          const cmpl wk = d21 * (d11 * A(j, k) - A(j, k + 1));
+          const cmpl wkp1 = d21 * (d22 * A(j, k + 1) - A(j, k));
+          for (size_t i = j; i < n; ++i)
+            A(i, j) -= A(i, k) * wk + A(i, k + 1) * wkp1;
+          A(j, k) = wk;
+          A(j, k + 1) = wkp1;
+        }
+      }
+      ipiv[k] = ipiv[k + 1] = -static_cast<int>(kp) - 1;
+    }
+    k += kstep;
+  }
+  return true;
+}
+
+/// @brief Solves A x = b in place for nrhs column-major right-hand sides of
+/// length n, given the output of bunch_kaufman_factor
+inline void bunch_kaufman_solve(const cmpl *a, const int *ipiv, size_t n,
+                                cmpl *b, size_t nrhs = 1) {
+  const auto A = [a, n](size_t i, size_t j) { return a[i + j * n]; };
+
+  for (size_t c = 0; c < nrhs; ++c) {
+    cmpl *x = b + c * n;
+
+    // L D y = b
+    size_t k = 0;
+    while (k < n) {
+      if (ipiv[k] >= 0) {
+        const auto kp = static_cast<size_t>(ipiv[k]);
+        if (kp != k)
+          std::swap(x[k], x[kp]);
+        for (size_t i = k + 1; i < n; ++i)
+          x[i] -= A(i, k) * x[k];
+        x[k] /= A(k, k);
+        k += 1;
+      } else {
+        const auto kp = static_cast<size_t>(-ipiv[k] - 1);
+        if (kp != k + 1)
+          std::swap(x[k + 1], x[kp]);
+        for (size_t i = k + 2; i < n; ++i)
+          x[i] -= A(i, k) * x[k] + A(i, k + 1) * x[k + 1];
+        const cmpl akm1k = A(k + 1, k);
+        const cmpl akm1 = A(k, k) / akm1k;
+        const cmpl ak = A(k + 1, k + 1) / akm1k;
+        const cmpl denom = akm1 * ak - 1.;
+        const cmpl bkm1 = x[k] / akm1k;
+        const cmpl bk = x[k + 1] / akm1k;
+        x[k] = (ak * bkm1 - bk) / denom;
+        x[k + 1] = (akm1 * bk - bkm1) / denom;
+        k += 2;
+      }
+    }
+
+    // L^T x = y
+    k = n;
+    while (k > 0) {
+      const auto kk = k - 1;
+      if (ipiv[kk] >= 0) {
+        for (size_t i = kk + 1; i < n; ++i)
+          x[kk] -= A(i, kk) * x[i];
+        const auto kp = static_cast<size_t>(ipiv[kk]);
+        if (kp != kk)
+          std::swap(x[kk], x[kp]);
+        k -= 1;
+      } else {
+        for (size_t i = kk + 1; i < n; ++i) {
+          x[kk] -= A(i, kk) * x[i];
+          x[kk - 1] -= A(i, kk - 1) * x[i];
+        }
+        const auto kp = static_cast<size_t>(-ipiv[kk] - 1);
+        if (kp != kk)
+          std::swap(x[kk], x[kp]);
+        k -= 2;
+      }
+    }
+  }
+}
+
+/// @brief LAPACK zsytrf/zsytrs, implemented in factorization.cpp so that the
+/// Fortran symbols are declared in a single translation unit. Pivots follow
+/// the LAPACK (1-based) convention. zsytrf runs in a per-thread workspace
+/// whose optimal size is queried once per n, so repeated factorizations do not
+/// allocate
+/// @returns LAPACK info
+int lapack_zsytrf(cmpl *a, int *ipiv, int n);
+int lapack_zsytrs(const cmpl *a, const int *ipiv, int n, cmpl *b, int nrhs);
+
+} // namespace detail
+
+/// @brief Bunch-Kaufman LDL^T factorization of a complex symmetric matrix of
+/// runtime size through LAPACK. Factor once, then solve for any number of
+/// right-hand sides. A default-constructed instance can be kept and refactored
+/// with factor(), reusing its storage, so that per-energy or per-sample solves
+/// of the same size do not allocate
+class SymmetricLDLT {
+private:
+  int n{};
+  std::vector<cmpl> factors;
+  std::vector<int> ipiv;
+
+public:
+  SymmetricLDLT() = default;
+
+  /// @param A complex symmetric matrix; only the lower triangle is referenced
+  explicit SymmetricLDLT(const xt::xtensor<cmpl, 2> &A) { factor(A); }
+
+  /// @brief factorizes A in place of the current factors
+  /// @param A complex symmetric matrix; only the lower triangle is referenced
+  void factor(const xt::xtensor<cmpl, 2> &A) {
+    assert(A.shape()[0] == A.shape()[1]);
+    const auto m = A.shape()[0];
+    n = static_cast<int>(m);
+    factors.resize(m * m);
+    ipiv.resize(m);
+    for (size_t j = 0; j < m; ++j)
+      for (size_t i = j; i < m; ++i)
+        factors[i + j * m] = A(i, j);
+    if (detail::lapack_zsytrf(factors.data(), ipiv.data(), n) != 0)
+      throw std::runtime_error("SymmetricLDLT: matrix is singular");
+  }
+
+  int size() const { return n; }
+
+  /// @brief overwrites the nrhs column-major right-hand sides b with A^-1 b
+  void solve(cmpl *b, size_t nrhs = 1) const {
+    detail::lapack_zsytrs(factors.data(), ipiv.data(), n, b,
+                          static_cast<int>(nrhs));
+  }
+
+  /// @returns x such that A x = b
+  xt::xtensor<cmpl, 1> solve(const xt::xtensor<cmpl, 1> &b) const {
+    assert(static_cast<int>(b.size()) == n);
+    auto x = xt::xtensor<cmpl, 1>(b);
+    solve(x.data());
+    return x;
+  }
+
+  /// @returns X such that A X = B, for each column of B
+  xt::xtensor<cmpl, 2> solve(const xt::xtensor<cmpl, 2> &B) const {
+    assert(static_cast<int>(B.shape()[0]) == n);
+    const auto m = B.shape()[0];
+    const auto nrhs = B.shape()[1];
+    auto x = std::vector<cmpl>(m * nrhs);
+    for (size_t c = 0; c < nrhs; ++c)
+      for (size_t i = 0; i < m; ++i)
+        x[i + c * m] = B(i, c);
+    solve(x.data(), nrhs);
+    auto X = xt::xtensor<cmpl, 2>({m, nrhs});
+    for (size_t c = 0; c < nrhs; ++c)
+      for (size_t i = 0; i < m; ++i)
+        X(i, c) = x[i + c * m];
+    return X;
+  }
+};
+
+/// @brief Hand-written Bunch-Kaufman LDL^T factorization of an N x N complex
+/// symmetric matrix with fixed-size storage, for small meshes where the
+/// overhead of calling LAPACK dominates
+template <size_t N> class FixedSymmetricLDLT {
+private:
+  std::array<cmpl, N * N> factors{};
+  std::array<int, N> ipiv{};
+
+public:
+  /// @param A column-major complex symmetric matrix; only the lower triangle
+  /// is referenced
+  explicit FixedSymmetricLDLT(const std::array<cmpl, N * N> &A) : factors(A) {
+    if (not detail::bunch_kaufman_factor(factors.data(), ipiv.data(), N))
+      throw std::runtime_error("FixedSymmetricLDLT: matrix is singular");
+  }
+
+  static constexpr size_t size() { return N; }
+
+  /// @returns x such that A x = b
+  std::array<cmpl, N> solve(std::array<cmpl, N> b) const {
+    detail::bunch_kaufman_solve(factors.data(), ipiv.data(), N, b.data());
+    return b;
+  }
+
+  /// @returns X such that A X = B, B being N x nrhs column-major
+  template <size_t NRHS>
+  std::array<cmpl, N * NRHS> solve(std::array<cmpl, N * NRHS> B) const {
+    detail::bunch_kaufman_solve(factors.data(), ipiv.data(), N, B.data(), NRHS);
+    return B;
+  }
+};
+
+/// @brief LU factorization with partial pivoting of a general N x N complex
+/// matrix with fixed-size storage, for the mesh matrices of non-symmetric
+/// non-local potentials that FixedSymmetricLDLT cannot take
+template <size_t N> class FixedLU {
+private:
+  std::array<cmpl, N * N> factors{};
+  std::array<size_t, N> ipiv{};
+
+public:
+  /// @param A column-major matrix
+  explicit FixedLU(const std::array<cmpl, N * N> &A) : factors(A) {
+    auto &a = factors;
+    for (size_t k = 0; k < N; ++k) {
+      size_t p = k;
+      for (size_t i = k + 1; i < N; ++i)
+        if (detail::cabs1(a[i + k * N]) > detail::cabs1(a[p + k * N]))
+          p = i;
+      ipiv[k] = p;
+      if (a[p + k * N] == 0.)
+        throw std::runtime_error("FixedLU: matrix is singular");
+      if (p != k)
+        for (size_t j = 0; j < N; ++j)
+          std::swap(a[k + j * N], a[p + j * N]);
+      const auto inv_pivot = 1. / a[k + k * N];
+      for (size_t i = k + 1; i < N; ++i)
+        a[i + k * N] *= inv_pivot;
+      for (size_t j = k + 1; j < N; ++j) {
+        const auto akj = a[k + j * N];
+        for (size_t i = k + 1; i < N; ++i)
+          a[i + j * N] -= a[i + k * N] * akj;
+      }
+    }
+  }
+
+  static constexpr size_t size() { return N; }
+
+  /// @returns x such that A x = b
+  std::array<cmpl, N> solve(std::array<cmpl, N> b) const {
+    const auto &a = factors;
+    // the row interchanges were applied to whole rows, L included
+    for (size_t k = 0; k < N; ++k)
+      std::swap(b[k], b[ipiv[k]]);
+    for (size_t k = 0; k < N; ++k)
+      for (size_t i = k + 1; i < N; ++i)
+        b[i] -= a[i + k * N] * b[k];
+    for (size_t k = N; k-- > 0;) {
+      b[k] /= a[k + k * N];
+      for (size_t i = 0; i < k; ++i)
+        b[i] -= a[i + k * N] * b[k];
+    }
+    return b;
+  }
+};
+
+} // namespace osiris
+
+#endif
@@ -0,0 +1,254 @@
+#ifndef LAGRANGE_MESH_SOLVER_HEADER
+#define LAGRANGE_MESH_SOLVER_HEADER
+
+#include "extern/legendre_rule.hpp"
+#ifdef OSIRIS_GL_TABLES
+#include "extern/gl_tables.hpp"
+#endif
+#include "potential/potential.hpp"
+#include "solver/channel.hpp"
+#include "solver/factorization.hpp"
+#include "solver/solver.hpp"
+#include "util/types.hpp"
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <complex>
+
+namespace osiris {
+
+namespace detail {
+
+constexpr real pi = 3.14159265358979323846;
+
+/// @brief cos(x) usable in constant expressions; Taylor series after reducing
+/// x to [-pi, pi]
+constexpr real constexpr_cos(real x) {
+  while (x > pi)
+    x -= 2 * pi;
+  while (x < -pi)
+    x += 2 * pi;
+  real term = 1;
+  real sum = 1;
+  for (int n = 1; n < 40; ++n) {
+    term *= -x * x / ((2 * n - 1) * (2 * n));
+    sum += term;
+  }
+  return sum;
+}
+
+/// @brief sqrt(x), x > 0, usable in constant expressions; Newton iteration
+constexpr real constexpr_sqrt(real x) {
+  real y = x > 1 ? x : 1;
+  for (int i = 0; i < 100; ++i) {
+    const auto next = 0.5 * (y + x / y);
+    if (next == y)
+      break;
+    y = next;
+  }
+  return y;
+}
+
+} // namespace detail
+
+} // namespace osiris
+
+namespace gl {
+
+/// @brief Gauss-Legendre rule of fixed order N on [0,1], with the abscissas
+/// in ascending order and weights summing to 1, matching
+/// generate_gauss_legendre_quadrature. The nodes are found by Newton
+/// iteration on P_N at compile time, unless N is one of the deployed mesh
+/// sizes specialized in the build-time generated gl_tables.hpp
+template <size_t N> struct FixedRule {
+  static constexpr std::array<zero_crossing, N> generate() {
+    using osiris::real;
+    auto rule = std::array<zero_crossing, N>{};
+    for (size_t k = 0; k < N; ++k) {
+      // k-th largest root of P_N on [-1, 1]
+      real x = osiris::detail::constexpr_cos(
+          osiris::detail::pi * (static_cast<real>(k) + 0.75) /
+          (static_cast<real>(N) + 0.5));
+      real dp = 1;
+      for (int iter = 0; iter < 100; ++iter) {
+        real p0 = 1;
+        real p1 = x;
+        for (size_t n = 2; n <= N; ++n) {
+          const auto p2 = ((2 * n - 1) * x * p1 - (n - 1) * p0) / n;
+          p0 = p1;
+          p1 = p2;
+        }
+        dp = N * (x * p1 - p0) / (x * x - 1);
+        const auto dx = p1 / dp;
+        x -= dx;
+        if (dx < 1e-16 and dx > -1e-16)
+          break;
+      }
+      // map to [0, 1] in ascending order
+      rule[N - 1 - k] =
+          zero_crossing{0.5 * (1 + x), 1. / ((1 - x * x) * dp * dp)};
+    }
+    return rule;
+  }
+
+  static constexpr std::array<zero_crossing, N> nodes = generate();
+};
+
+} // namespace gl
+
+namespace osiris {
+
+/// @brief Calculable R-matrix method on a Lagrange-Legendre mesh of
+/// compile-time size N, see RMatrixKernel. The quadrature, kinetic plus Bloch
+/// matrix and boundary values are constant expressions, the mesh matrix lives
+/// in std::array storage on the stack, and it is factorized by a
+/// FixedSymmetricLDLT<N>, so a solve does not allocate on the heap beyond
+/// what the potential's parameter type does. Intended for small N (15-30).
+template <size_t N> class LagrangeMeshSolver {
+private:
+  static constexpr auto &quadrature = gl::FixedRule<N>::nodes;
+
+  static constexpr std::array<real, N * N> generate_kinetic_bloch() {
+    const auto n = static_cast<real>(N);
+    auto tl = std::array<real, N * N>{};
+    for (size_t i = 0; i < N; ++i) {
+      const auto xi = quadrature[i].abscissa;
+      tl[i + i * N] = ((4 * n * n + 4 * n + 3) * xi * (1 - xi) - 6 * xi + 1) /
+                      (3 * xi * xi * (1 - xi) * (1 - xi));
+      for (size_t j = 0; j < i; ++j) {
+        const auto xj = quadrature[j].abscissa;
+        const auto sign = (i + j) % 2 == 0 ? 1. : -1.;
+        tl[i + j * N] =
+            sign *
+            (n * n + n + 1 + (xi + xj - 2 * xi * xj) / ((xi - xj) * (xi - xj)) -
+             1. / (1 - xi) - 1. / (1 - xj)) /
+            detail::constexpr_sqrt(xi * xj * (1 - xi) * (1 - xj));
+        tl[j + i * N] = tl[i + j * N];
+      }
+    }
+    return tl;
+  }
+
+  static constexpr std::array<real, N> generate_boundary() {
+    auto f = std::array<real, N>{};
+    for (size_t i = 0; i < N; ++i) {
+      const auto xi = quadrature[i].abscissa;
+      const auto sign = (N + i + 1) % 2 == 0 ? 1. : -1.;
+      f[i] = sign / detail::constexpr_sqrt(xi * (1 - xi));
+    }
+    return f;
+  }
+
+  /// @brief <f_i|T + L|f_j> in units of hbar^2/(2 mu a^2), column-major
+  static constexpr std::array<real, N * N> kinetic_bloch =
+      generate_kinetic_bloch();
+  /// @brief Lagrange functions at the channel radius in units of a^(-1/2)
+  static constexpr std::array<real, N> boundary = generate_boundary();
+
+  real radius;
+
+  /// @returns T + L + l(l+1)/r^2 - k^2 in units of hbar^2/(2 mu a^2)
+  std::array<cmpl, N * N> free_matrix(real s, int l) const {
+    const auto ll = static_cast<real>(l * (l + 1));
+    auto C = std::array<cmpl, N * N>{};
+    for (size_t k = 0; k < N * N; ++k)
+      C[k] = kinetic_bloch[k];
+    for (size_t i = 0; i < N; ++i) {
+      const auto xi = quadrature[i].abscissa;
+      C[i + i * N] += ll / (xi * xi) - s * s;
+    }
+    return C;
+  }
+
+  /// @param symmetric false when C isn't complex symmetric, e.g. for
+  /// non-symmetric non-local potentials, which then use LU
+  cmpl boundary_projection(const std::array<cmpl, N * N> &C,
+                           bool symmetric = true) const {
+    auto b = std::array<cmpl, N>{};
+    for (size_t i = 0; i < N; ++i)
+      b[i] = boundary[i];
+    const auto x = symmetric ? FixedSymmetricLDLT<N>(C).solve(b)
+                             : FixedLU<N>(C).solve(b);
+    cmpl R = 0;
+    for (size_t i = 0; i < N; ++i)
+      R += boundary[i] * x[i];
+    return R;
+  }
+
+public:
+  /// @param radius channel radius [fm]
+  explicit LagrangeMeshSolver(real radius) : radius(radius) {
+    assert(radius > 0);
+  }
+
+  static constexpr size_t size() { return N; }
+
+  /// @returns mesh points r_i [fm]
+  std::array<real, N> mesh() const {
+    auto r = std::array<real, N>{};
+    for (size_t i = 0; i < N; ++i)
+      r[i] = radius * quadrature[i].abscissa;
+    return r;
+  }
+
+  /// @returns the dimensionless R-matrix at the channel radius for a local
+  /// potential
+  template <class T>
+  cmpl rmatrix(const Channel &ch, const Channel::Energetics &e,
+               const Channel::FermionSpinOrbitCoupling &am,
+               const Potential<T> &v, const T &params) const {
+    assert(ch.radius == radius);
+    const auto scale = radius / e.h2ma;
+    const auto r = mesh();
+    auto vr = std::array<cmpl, N>{};
+    v.batch(r.data(), N, params, vr.data());
+    auto C = free_matrix(e.k * radius, am.l);
+    for (size_t i = 0; i < N; ++i)
+      C[i + i * N] += scale * vr[i];
+    return boundary_projection(C);
+  }
+
+  /// @returns the dimensionless R-matrix at the channel radius for a
+  /// non-local potential
+  template <class T>
+  cmpl rmatrix(const Channel &ch, const Channel::Energetics &e,
+               const Channel::FermionSpinOrbitCoupling &am,
+               const NonlocalPotential<T> &v, const T &params) const {
+    assert(ch.radius == radius);
+    const auto scale = radius / e.h2ma;
+    const auto r = mesh();
+    const bool symmetric = v.is_symmetric(params);
+    auto C = free_matrix(e.k * radius, am.l);
+    auto row = std::array<cmpl, N>{};
+    for (size_t i = 0; i < N; ++i) {
+      // upper triangle of row i, mirrored into column i, or the whole row
+      const auto j0 = symmetric ? i : 0;
+      v.tile(&r[i], 1, &r[j0], N - j0, params, row.data());
+      for (size_t j = j0; j < N; ++j) {
+        const auto vij =
+            scale * radius *
+            sqrt(quadrature[i].weight * quadrature[j].weight) * row[j - j0];
+        C[i + j * N] += vij;
+        if (symmetric and j != i)
+          C[j + i * N] += vij;
+      }
+    }
+    return boundary_projection(C, symmetric);
+  }
+
+  /// @returns R-matrix, S-matrix and phase shift for a local or non-local
+  /// potential
+  template <class Pot, class T>
+  ScatteringMatrices matrices(const Channel &ch, const Channel::Energetics &e,
+                              const Channel::FermionSpinOrbitCoupling &am,
+                              const Pot &v, const T &params) const {
+    return ScatteringMatrices(rmatrix(ch, e, am, v, params),
+                              ch.set_angular_momentum(am, e),
+                              e.k * radius);
+  }
+};
+
+} // namespace osiris
+
+#endif
@@ -3,24 +3,1087 @@
 
 #include "extern/legendre_rule.hpp"
 #include "potential/potential.hpp"
+#include "solver/asymptotics_cache.hpp"
+#include "solver/factorization.hpp"
 #include "solver/channel.hpp"
 #include "util/asymptotics.hpp"
 #include "util/config.hpp"
 #include "util/constants.hpp"
 #include "util/types.hpp"
 
+#include "xtensor-blas/xlinalg.hpp"
+#include "xtensor/xtensor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
 namespace osiris {
 
+/// @brief R-matrix, S-matrix and phase shift of a single partial wave
+struct ScatteringMatrices {
+  /// @brief R-matrix at the channel radius [dimensionless]
+  cmpl R;
+  /// @brief nuclear S-matrix, exp(2 i delta); for charged channels this is
+  /// relative to Coulomb scattering, with the Coulomb phase left out
+  cmpl S;
+  /// @brief nuclear phase shift delta [radians]; complex for absorptive
+  /// potentials
+  cmpl phase_shift;
+
+  /// @param R R-matrix at the channel radius
+  /// @param asym asymptotic wavefunctions at the channel radius
+  /// @param s k * channel radius [dimensionless]
+  ScatteringMatrices(cmpl R, const Channel::Asymptotics &asym, real s)
+      : R(R), S((asym.wvfxn_in - s * R * asym.wvfxn_deriv_in) /
+                (asym.wvfxn_out - s * R * asym.wvfxn_deriv_out)),
+        phase_shift(std::log(S) / (2. * constants::i)) {}
+
+  /// @returns K-matrix, tan(delta)
+  cmpl K() const { return std::tan(phase_shift); }
+
+  /// @returns dS/dR at fixed energy,
+  /// s (H+' H- - H-' H+) / (H+ - s R H+')^2
+  static cmpl dS_dR(cmpl R, const Channel::Asymptotics &asym, real s) {
+    const auto denom = asym.wvfxn_out - s * R * asym.wvfxn_deriv_out;
+    return s *
+           (asym.wvfxn_deriv_out * asym.wvfxn_in -
+            asym.wvfxn_deriv_in * asym.wvfxn_out) /
+           (denom * denom);
+  }
+};
+
+/// @brief ScatteringMatrices of a single partial wave along with their
+/// derivatives with respect to each parameter of the potential
+struct ScatteringDerivatives {
+  ScatteringMatrices matrices;
+  /// @brief dR/dp_k [dimensionless per unit of p_k]
+  xt::xtensor<cmpl, 1> dR;
+  /// @brief dS/dp_k
+  xt::xtensor<cmpl, 1> dS;
+};
+
+/// @brief ScatteringMatrices of a single partial wave along with their
+/// sensitivities to the local potential at each mesh point, from which the
+/// derivatives with respect to any number of parameters follow by the chain
+/// rule
+struct MeshSensitivities {
+  ScatteringMatrices matrices;
+  /// @brief dR/dV(r_i) [MeV^-1]
+  xt::xtensor<cmpl, 1> dR_dV;
+  /// @brief dS/dV(r_i) [MeV^-1]
+  xt::xtensor<cmpl, 1> dS_dV;
+
+  /// @param dV derivatives of the potential on the mesh with respect to
+  /// nparams parameters, dV[k * nbasis + i] = d/dp_k V(r_i) [MeV]
+  /// @returns derivatives of R and S with respect to the parameters
+  ScatteringDerivatives derivatives(const cmpl *dV, size_t nparams) const {
+    const auto n = dR_dV.size();
+    auto result = ScatteringDerivatives{
+        matrices, xt::xtensor<cmpl, 1>(std::array<size_t, 1>{nparams}),
+        xt::xtensor<cmpl, 1>(std::array<size_t, 1>{nparams})};
+    for (size_t k = 0; k < nparams; ++k) {
+      result.dR(k) = 0;
+      result.dS(k) = 0;
+      for (size_t i = 0; i < n; ++i) {
+        result.dR(k) += dR_dV(i) * dV[k * n + i];
+        result.dS(k) += dS_dV(i) * dV[k * n + i];
+      }
+    }
+    return result;
+  }
+};
+
+/// @brief R-matrix and S-matrix between the channels of a coupled-channel
+/// problem, indexed (c, c')
+struct CoupledScatteringMatrices {
+  /// @brief R-matrix at the channel radius [dimensionless], symmetric
+  xt::xtensor<cmpl, 2> R;
+  /// @brief collision matrix; S(c, c') is the amplitude to exit in channel c
+  /// when entering in channel c'
+  xt::xtensor<cmpl, 2> S;
+};
+
+/// @brief Local coupling between channels of the form
+/// V_cc'(r) = strengths(c, c') * form_factor(r), e.g. a deformation length
+/// times the derivative of the optical potential for collective excitation.
+/// The form factor is evaluated once per mesh point and shared by every pair
+/// of channels
+template <class T> struct ChannelCoupling {
+  const Potential<T> &form_factor;
+  T params;
+  /// @brief symmetric nchannels x nchannels strengths; the diagonal is ignored
+  /// and zero entries leave the corresponding channels uncoupled
+  xt::xtensor<real, 2> strengths;
+};
+
+/// @brief Pole expansion of the R-matrix of a single partial wave,
+/// R(E) = sum_n gamma_n^2 / (E_n - E), obtained by diagonalizing the
+/// Bloch-augmented mesh Hamiltonian of an energy-independent potential. Once
+/// built, each energy costs O(nbasis) rather than an O(nbasis^3) solve.
+/// The poles and widths also carry their first derivatives with respect to
+/// hbar^2/(2 mu), so that nearby reduced masses cost no rediagonalization
+struct RMatrixPoles {
+  /// @brief hbar^2/(2 mu) at which the Hamiltonian was diagonalized [MeV fm^2]
+  real h2m;
+  /// @brief pole energies E_n [MeV]; complex for absorptive potentials
+  xt::xtensor<cmpl, 1> energies;
+  /// @brief reduced widths gamma_n^2 [MeV]
+  xt::xtensor<cmpl, 1> reduced_widths;
+  /// @brief dE_n / d(hbar^2/(2 mu)) [fm^-2]
+  xt::xtensor<cmpl, 1> energy_slopes;
+  /// @brief d(gamma_n^2) / d(hbar^2/(2 mu)) [fm^-2]
+  xt::xtensor<cmpl, 1> width_slopes;
+
+  /// @returns dimensionless R-matrix at energy erg = hbar^2 k^2/(2 mu) [MeV]
+  cmpl operator()(real erg) const {
+    cmpl R = 0;
+    for (size_t n = 0; n < energies.size(); ++n)
+      R += reduced_widths(n) / (energies(n) - erg);
+    return R;
+  }
+
+  /// @returns dimensionless R-matrix at energy erg [MeV] for hbar^2/(2 mu) =
+  /// h2m_at [MeV fm^2], the poles and widths being corrected to first order
+  /// in h2m_at - h2m; the error is second order in the relative drift
+  cmpl operator()(real erg, real h2m_at) const {
+    const auto d = h2m_at - h2m;
+    cmpl R = 0;
+    for (size_t n = 0; n < energies.size(); ++n)
+      R += (reduced_widths(n) + d * width_slopes(n)) /
+           (energies(n) + d * energy_slopes(n) - erg);
+    return R;
+  }
+
+  /// @returns dimensionless R-matrix at wavenumber k [fm^-1]
+  cmpl at_wavenumber(real k) const { return operator()(h2m * k * k); }
+};
+
+/// @brief Calculable R-matrix method on a Lagrange-Legendre mesh, regularized
+/// by x, as described in:
+/// Descouvemont, P., and D. Baye.
+/// "The R-matrix theory." Reports on Progress in Physics 73.3 (2010): 036301.
+///
+/// All matrices are kept dimensionless by measuring r in units of the channel
+/// radius a and energies in units of hbar^2/(2 mu a^2). In these units the
+/// kinetic plus Bloch operator depends only on nbasis, so it is built once on
+/// construction and reused for every channel radius, energy, partial wave and
+/// potential passed to the kernel; only the diagonal changes between solves.
 class RMatrixKernel {
 private:
   const int nbasis{};
   const int nchannels{};
-  std::vector<gl::zero_crossing> quadrature;
+  const Factorization factorization{};
+  /// @brief shared with the process-wide quadrature cache
+  const std::vector<gl::zero_crossing> &quadrature;
+  /// @brief <f_i|T + L|f_j> in units of hbar^2/(2 mu a^2), T being the radial
+  /// kinetic energy operator and L the Bloch operator
+  const xt::xtensor<real, 2> kinetic_bloch;
+  /// @brief Lagrange functions at the channel radius, f_i(a), in units of
+  /// a^(-1/2)
+  const xt::xtensor<real, 1> boundary;
+
+  /// @brief eigen-decomposition of the free Bloch-augmented Hamiltonian,
+  /// T + L + l(l+1)/r^2 = Q diag(eigenvalues) Q^T, in units of
+  /// hbar^2/(2 mu a^2)
+  struct FreeSpectrum {
+    xt::xtensor<real, 1> eigenvalues;
+    /// @brief Q, eigenvectors in columns
+    xt::xtensor<real, 2> eigenvectors;
+    /// @brief Q^T f, the boundary values in the eigenbasis
+    xt::xtensor<real, 1> boundary;
+  };
+
+  /// @brief off-diagonal block of the coupled-channel mesh matrix [MeV]. A
+  /// local coupling is diagonal on the Lagrange mesh, so a block is stored as
+  /// its diagonal until elimination fills it in, and only then as dense
+  struct CouplingBlock {
+    /// @brief the diagonal, empty once the block is dense
+    std::vector<cmpl> diagonal;
+    xt::xtensor<cmpl, 2> dense;
+
+    bool is_dense() const { return diagonal.empty(); }
+
+    /// @returns the n x n dense block, converting a diagonal one or
+    /// allocating zeros for a block that was absent
+    xt::xtensor<cmpl, 2> &densify(size_t n) {
+      if (dense.shape()[0] != n) {
+        dense = xt::zeros<cmpl>({n, n});
+        for (size_t i = 0; i < diagonal.size(); ++i)
+          dense(i, i) = diagonal[i];
+        diagonal.clear();
+      }
+      return dense;
+    }
+  };
+
+  /// @brief free spectra, built lazily for each l on first use
+  struct FreeSpectra {
+    std::array<std::once_flag, MAXL> built;
+    std::array<FreeSpectrum, MAXL> spectra;
+  };
+  std::shared_ptr<FreeSpectra> free_spectra{std::make_shared<FreeSpectra>()};
+
+  static xt::xtensor<real, 2>
+  generate_kinetic_bloch(const std::vector<gl::zero_crossing> &quadrature) {
+    const auto n = quadrature.size();
+    const auto N = static_cast<real>(n);
+    auto tl = xt::xtensor<real, 2>({n, n});
+    for (size_t i = 0; i < n; ++i) {
+      const auto xi = quadrature[i].abscissa;
+      tl(i, i) =
+          ((4 * N * N + 4 * N + 3) * xi * (1 - xi) - 6 * xi + 1) /
+          (3 * xi * xi * (1 - xi) * (1 - xi));
+      for (size_t j = 0; j < i; ++j) {
+        const auto xj = quadrature[j].abscissa;
+        const auto sign = (i + j) % 2 == 0 ? 1. : -1.;
+        tl(i, j) = sign *
+                   (N * N + N + 1 +
+                    (xi + xj - 2 * xi * xj) / ((xi - xj) * (xi - xj)) -
+                    1. / (1 - xi) - 1. / (1 - xj)) /
+                   sqrt(xi * xj * (1 - xi) * (1 - xj));
+        tl(j, i) = tl(i, j);
+      }
+    }
+    return tl;
+  }
+
+  static xt::xtensor<real, 1>
+  generate_boundary(const std::vector<gl::zero_crossing> &quadrature) {
+    const auto n = quadrature.size();
+    auto f = xt::xtensor<real, 1>(std::array<size_t, 1>{n});
+    for (size_t i = 0; i < n; ++i) {
+      const auto xi = quadrature[i].abscissa;
+      const auto sign = (n + i + 1) % 2 == 0 ? 1. : -1.;
+      f(i) = sign / sqrt(xi * (1 - xi));
+    }
+    return f;
+  }
+
+  /// @returns the LDL^T factors of C in storage owned by the calling thread,
+  /// reused by every solve of the thread so that it does not allocate; valid
+  /// until the thread's next call
+  static const SymmetricLDLT &thread_ldlt(const xt::xtensor<cmpl, 2> &C) {
+    thread_local auto ldlt = SymmetricLDLT();
+    ldlt.factor(C);
+    return ldlt;
+  }
+
+  /// @returns f^T C^-1 f, f being the Lagrange functions at the channel radius
+  /// @param symmetric false when C isn't complex symmetric, e.g. for
+  /// non-symmetric non-local potentials, which then always use LU
+  cmpl boundary_projection(const xt::xtensor<cmpl, 2> &C,
+                           bool symmetric = true) const {
+    const auto b = xt::xtensor<cmpl, 1>(boundary);
+    xt::xtensor<cmpl, 1> x;
+    if (symmetric and factorization == Factorization::symmetric)
+      x = thread_ldlt(C).solve(b);
+    else
+      x = xt::linalg::solve(C, b);
+    cmpl R = 0;
+    for (size_t i = 0; i < quadrature.size(); ++i)
+      R += boundary(i) * x(i);
+    return R;
+  }
+
+  /// @returns D^-1 B using the kernel's factorization
+  xt::xtensor<cmpl, 2> solve_block(const xt::xtensor<cmpl, 2> &D,
+                                   const xt::xtensor<cmpl, 2> &B) const {
+    if (factorization == Factorization::symmetric)
+      return SymmetricLDLT(D).solve(B);
+    return xt::linalg::solve(D, B);
+  }
+
+  const FreeSpectrum &free_spectrum(int l) const {
+    assert(l >= 0 and l < MAXL);
+    std::call_once(free_spectra->built[l], [this, l]() {
+      const auto n = quadrature.size();
+      auto H = xt::xtensor<real, 2>(kinetic_bloch);
+      for (size_t i = 0; i < n; ++i) {
+        const auto xi = quadrature[i].abscissa;
+        H(i, i) += static_cast<real>(l * (l + 1)) / (xi * xi);
+      }
+      auto [eigvals, eigvecs] = xt::linalg::eigh(H);
+      auto fhat = xt::xtensor<real, 1>(std::array<size_t, 1>{n});
+      for (size_t m = 0; m < n; ++m) {
+        fhat(m) = 0;
+        for (size_t i = 0; i < n; ++i)
+          fhat(m) += eigvecs(i, m) * boundary(i);
+      }
+      free_spectra->spectra[l] =
+          FreeSpectrum{std::move(eigvals), std::move(eigvecs), std::move(fhat)};
+    });
+    return free_spectra->spectra[l];
+  }
+
+  /// @returns the dimensionless R-matrix for a separable potential,
+  /// C = C0 + U L U^T, by the Woodbury identity,
+  /// R = f^T C0^-1 f - p^T (L^-1 + U^T C0^-1 U)^-1 p,  p = U^T C0^-1 f,
+  /// with C0 the free matrix, diagonal in its cached eigenbasis. This costs
+  /// O(nbasis^2 rank) rather than the O(nbasis^3) dense solve
+  template <class T>
+  cmpl separable_rmatrix(const Channel &ch, const Channel::Energetics &e,
+                         const Channel::FermionSpinOrbitCoupling &am,
+                         const SeparablePotential<T> &v,
+                         const T &params) const {
+    const auto n = quadrature.size();
+    const auto rank = v.rank();
+    const auto a = ch.radius;
+    const auto s = e.k * a;
+    const auto scale = a / e.h2ma;
+    const auto &spectrum = free_spectrum(am.l);
+
+    // free propagator in the eigenbasis
+    auto propagator = std::vector<real>(n);
+    for (size_t m = 0; m < n; ++m)
+      propagator[m] = 1. / (spectrum.eigenvalues(m) - s * s);
+
+    // U(i, q) = sqrt(w_i) g_q(r_i), projected onto the eigenbasis
+    auto U = xt::xtensor<real, 2>({n, rank});
+    for (size_t q = 0; q < rank; ++q) {
+      auto g = std::vector<real>(n);
+      for (size_t i = 0; i < n; ++i)
+        g[i] = sqrt(quadrature[i].weight) *
+               v.form_factor(q, a * quadrature[i].abscissa, params);
+      for (size_t m = 0; m < n; ++m) {
+        U(m, q) = 0;
+        for (size_t i = 0; i < n; ++i)
+          U(m, q) += spectrum.eigenvectors(i, m) * g[i];
+      }
+    }
+
+    real R0 = 0;
+    for (size_t m = 0; m < n; ++m)
+      R0 += spectrum.boundary(m) * spectrum.boundary(m) * propagator[m];
+
+    auto p = xt::xtensor<cmpl, 1>(std::array<size_t, 1>{rank});
+    auto M = xt::xtensor<cmpl, 2>({rank, rank});
+    for (size_t q = 0; q < rank; ++q) {
+      p(q) = 0;
+      for (size_t m = 0; m < n; ++m)
+        p(q) += U(m, q) * spectrum.boundary(m) * propagator[m];
+      for (size_t qq = 0; qq < rank; ++qq) {
+        M(q, qq) = 0;
+        for (size_t m = 0; m < n; ++m)
+          M(q, qq) += U(m, q) * U(m, qq) * propagator[m];
+      }
+      const auto lambda = scale * a * v.strength(q, params);
+      assert(lambda != 0.);
+      M(q, q) += 1. / lambda;
+    }
+
+    const xt::xtensor<cmpl, 1> y = xt::linalg::solve(M, p);
+    cmpl R = R0;
+    for (size_t q = 0; q < rank; ++q)
+      R -= p(q) * y(q);
+    return R;
+  }
+
+  /// @returns the sensitivities of a partial wave to the potential vr [MeV]
+  /// on the mesh, see sensitivities
+  MeshSensitivities
+  mesh_sensitivities(const Channel &ch, const Channel::Energetics &e,
+                     const Channel::FermionSpinOrbitCoupling &am,
+                     const std::vector<cmpl> &vr) const {
+    const auto n = quadrature.size();
+    const auto a = ch.radius;
+    const auto s = e.k * a;
+    const auto scale = a / e.h2ma;
+
+    auto C = free_matrix(s, am.l);
+    for (size_t i = 0; i < n; ++i)
+      C(i, i) += scale * vr[i];
+    const auto b = xt::xtensor<cmpl, 1>(boundary);
+    // C is complex symmetric, so the adjoint system C^T y = f is the forward
+    // one and y = x
+    xt::xtensor<cmpl, 1> x;
+    if (factorization == Factorization::symmetric)
+      x = thread_ldlt(C).solve(b);
+    else
+      x = xt::linalg::solve(C, b);
+
+    cmpl R = 0;
+    for (size_t i = 0; i < n; ++i)
+      R += boundary(i) * x(i);
+    const auto asym = ch.set_angular_momentum(am, e);
+    const auto dS_dR = ScatteringMatrices::dS_dR(R, asym, s);
+
+    auto result = MeshSensitivities{
+        ScatteringMatrices(R, asym, s),
+        xt::xtensor<cmpl, 1>(std::array<size_t, 1>{n}),
+        xt::xtensor<cmpl, 1>(std::array<size_t, 1>{n})};
+    for (size_t i = 0; i < n; ++i) {
+      result.dR_dV(i) = -scale * x(i) * x(i);
+      result.dS_dV(i) = dS_dR * result.dR_dV(i);
+    }
+    return result;
+  }
+
+  /// @returns V(r_i) [MeV] on the mesh at a given channel radius [fm], from a
+  /// single batched call into the potential
+  template <class T>
+  std::vector<cmpl> on_mesh(real radius, const Potential<T> &v,
+                            const T &params) const {
+    const auto r = mesh(radius);
+    auto vr = std::vector<cmpl>(r.size());
+    v.batch(r.data(), r.size(), params, vr.data());
+    return vr;
+  }
 
 public:
-  RMatrixKernel(int nbasis, int nchannels)
-      : nbasis(nbasis), nchannels(nchannels),
-        quadrature(gl::generate_gauss_legendre_quadrature(nbasis)) {}
+  RMatrixKernel(int nbasis, int nchannels,
+                Factorization factorization = Factorization::symmetric)
+      : nbasis(nbasis), nchannels(nchannels), factorization(factorization),
+        quadrature(gl::gauss_legendre_quadrature(nbasis)),
+        kinetic_bloch(generate_kinetic_bloch(quadrature)),
+        boundary(generate_boundary(quadrature)) {
+    assert(nbasis > 0);
+    assert(nchannels > 0);
+  }
+
+  int size() const { return nbasis; }
+
+  /// @returns mesh points r_i [fm] for a given channel radius [fm]
+  xt::xtensor<real, 1> mesh(real radius) const {
+    auto r = xt::xtensor<real, 1>(std::array<size_t, 1>{quadrature.size()});
+    for (size_t i = 0; i < quadrature.size(); ++i)
+      r(i) = radius * quadrature[i].abscissa;
+    return r;
+  }
+
+  /// @returns Lagrange functions at the channel radius, f_i(a), in units of
+  /// a^(-1/2)
+  const xt::xtensor<real, 1> &boundary_values() const { return boundary; }
+
+  /// @returns the potential-independent part of the Bloch-augmented
+  /// Hamiltonian minus the energy, T + L + l(l+1)/r^2 - k^2, in units of
+  /// hbar^2/(2 mu a^2)
+  /// @param s k * channel radius [dimensionless]
+  /// @param l orbital angular momentum
+  xt::xtensor<cmpl, 2> free_matrix(real s, int l) const {
+    const auto n = quadrature.size();
+    const auto ll = static_cast<real>(l * (l + 1));
+    auto C = xt::xtensor<cmpl, 2>({n, n});
+    for (size_t i = 0; i < n; ++i) {
+      for (size_t j = 0; j < n; ++j)
+        C(i, j) = kinetic_bloch(i, j);
+      const auto xi = quadrature[i].abscissa;
+      C(i, i) += ll / (xi * xi) - s * s;
+    }
+    return C;
+  }
+
+  /// @returns the dimensionless R-matrix at the channel radius for a local
+  /// potential
+  template <class T>
+  cmpl rmatrix(const Channel &ch, const Channel::Energetics &e,
+               const Channel::FermionSpinOrbitCoupling &am,
+               const Potential<T> &v, T params) const {
+    const auto a = ch.radius;
+    // converts [MeV] to units of hbar^2/(2 mu a^2)
+    const auto scale = a / e.h2ma;
+
+    const auto vr = on_mesh(a, v, params);
+    auto C = free_matrix(e.k * a, am.l);
+    for (size_t i = 0; i < quadrature.size(); ++i)
+      C(i, i) += scale * vr[i];
+    return boundary_projection(C);
+  }
+
+  /// @returns the mesh matrix of a non-local potential,
+  /// a sqrt(w_i w_j) V(r_i, r_j) [MeV], at a given channel radius [fm].
+  /// The potential is evaluated in square tiles so each call into it covers a
+  /// cache-sized block of pairs, and the tiles are optionally distributed over
+  /// nthreads threads. Only the upper triangle is evaluated, and mirrored,
+  /// when v.is_symmetric(params)
+  template <class T>
+  xt::xtensor<cmpl, 2> nonlocal_matrix(real radius,
+                                       const NonlocalPotential<T> &v,
+                                       const T &params, int nthreads = 1) const {
+    const bool symmetric = v.is_symmetric(params);
+    constexpr size_t tile_size = 16;
+    const auto n = quadrature.size();
+
+    auto r = std::vector<real>(n);
+    auto sqrt_w = std::vector<real>(n);
+    for (size_t i = 0; i < n; ++i) {
+      r[i] = radius * quadrature[i].abscissa;
+      sqrt_w[i] = sqrt(quadrature[i].weight);
+    }
+
+    auto tiles = std::vector<std::pair<size_t, size_t>>{};
+    for (size_t i0 = 0; i0 < n; i0 += tile_size)
+      for (size_t j0 = symmetric ? i0 : 0; j0 < n; j0 += tile_size)
+        tiles.emplace_back(i0, j0);
+
+    auto M = xt::xtensor<cmpl, 2>({n, n});
+    const auto nworkers =
+        static_cast<size_t>(std::max(1, std::min(nthreads, (int)tiles.size())));
+
+    // each tile writes a disjoint set of entries, and its mirror image if
+    // the potential is symmetric
+    const auto assemble = [&](size_t worker) {
+      auto buffer = std::vector<cmpl>(tile_size * tile_size);
+      for (size_t t = worker; t < tiles.size(); t += nworkers) {
+        const auto [i0, j0] = tiles[t];
+        const auto i1 = std::min(i0 + tile_size, n);
+        const auto j1 = std::min(j0 + tile_size, n);
+        for (size_t i = i0; i < i1; ++i) {
+          // on diagonal tiles, start each row at the diagonal
+          const auto jstart = symmetric and i0 == j0 ? i : j0;
+          const auto nj = j1 - jstart;
+          v.tile(&r[i], 1, &r[jstart], nj, params, buffer.data());
+          for (size_t j = jstart; j < j1; ++j) {
+            const auto vij =
+                radius * sqrt_w[i] * sqrt_w[j] * buffer[j - jstart];
+            M(i, j) = vij;
+            if (symmetric)
+              M(j, i) = vij;
+          }
+        }
+      }
+    };
+
+    if (nworkers == 1) {
+      assemble(0);
+    } else {
+      auto workers = std::vector<std::thread>{};
+      for (size_t w = 0; w < nworkers; ++w)
+        workers.emplace_back(assemble, w);
+      for (auto &w : workers)
+        w.join();
+    }
+    return M;
+  }
+
+  /// @returns the dimensionless R-matrix at the channel radius for a
+  /// non-local potential. Separable potentials are detected and solved as a
+  /// low-rank update of free propagation without assembling the mesh matrix
+  template <class T>
+  cmpl rmatrix(const Channel &ch, const Channel::Energetics &e,
+               const Channel::FermionSpinOrbitCoupling &am,
+               const NonlocalPotential<T> &v, const T &params,
+               int nthreads = 1) const {
+    if (const auto *separable = dynamic_cast<const SeparablePotential<T> *>(&v))
+      return separable_rmatrix(ch, e, am, *separable, params);
+
+    const auto n = quadrature.size();
+    const auto scale = ch.radius / e.h2ma;
+    const auto V = nonlocal_matrix(ch.radius, v, params, nthreads);
+    auto C = free_matrix(e.k * ch.radius, am.l);
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < n; ++j)
+        C(i, j) += scale * V(i, j);
+    return boundary_projection(C, v.is_symmetric(params));
+  }
+
+  /// @returns the pole expansion of the R-matrix for a local,
+  /// energy-independent potential. The reduced mass is frozen at its value in
+  /// e, so the expansion is exact wherever the reduced mass is the same
+  template <class T>
+  RMatrixPoles poles(const Channel &ch, const Channel::Energetics &e,
+                     const Channel::FermionSpinOrbitCoupling &am,
+                     const Potential<T> &v, T params) const {
+    const auto n = quadrature.size();
+    const auto a = ch.radius;
+    const auto scale = a / e.h2ma;
+    // converts eigenvalues of the dimensionless Hamiltonian to [MeV]
+    const auto to_MeV = e.h2ma / a;
+
+    const auto vr = on_mesh(a, v, params);
+    // the kinetic part, which is all that scales with hbar^2/(2 mu)
+    const auto F = free_matrix(0., am.l);
+    auto H = F;
+    bool is_real = true;
+    for (size_t i = 0; i < n; ++i) {
+      const cmpl vi = vr[i];
+      is_real = is_real and vi.imag() == 0.;
+      H(i, i) += scale * vi;
+    }
+
+    // eigenvalues of H and eigenvectors normalized to q^T q = 1
+    auto eps = xt::xtensor<cmpl, 1>(std::array<size_t, 1>{n});
+    auto Q = xt::xtensor<cmpl, 2>({n, n});
+    if (is_real) {
+      // real symmetric: orthonormal eigenvectors
+      auto Hr = xt::xtensor<real, 2>({n, n});
+      for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j)
+          Hr(i, j) = H(i, j).real();
+      const auto [eigvals, eigvecs] = xt::linalg::eigh(Hr);
+      for (size_t m = 0; m < n; ++m) {
+        eps(m) = eigvals(m);
+        for (size_t i = 0; i < n; ++i)
+          Q(i, m) = eigvecs(i, m);
+      }
+    } else {
+      // complex symmetric: eigenvectors are orthogonal under the
+      // (unconjugated) transpose, so normalize with q^T q
+      const auto [eigvals, eigvecs] = xt::linalg::eig(H);
+      for (size_t m = 0; m < n; ++m) {
+        cmpl norm = 0;
+        for (size_t i = 0; i < n; ++i)
+          norm += eigvecs(i, m) * eigvecs(i, m);
+        const auto inv_sqrt = 1. / sqrt(norm);
+        eps(m) = eigvals(m);
+        for (size_t i = 0; i < n; ++i)
+          Q(i, m) = eigvecs(i, m) * inv_sqrt;
+      }
+    }
+
+    auto poles = RMatrixPoles{e.h2ma * a,
+                              xt::xtensor<cmpl, 1>(std::array<size_t, 1>{n}),
+                              xt::xtensor<cmpl, 1>(std::array<size_t, 1>{n}),
+                              xt::xtensor<cmpl, 1>(std::array<size_t, 1>{n}),
+                              xt::xtensor<cmpl, 1>(std::array<size_t, 1>{n})};
+    // gamma_m = f(a) . q_m, and the kinetic part in the eigenbasis, Q^T F Q,
+    // which gives dE_n/dh2m = (Q^T F Q)_nn / a^2 and, through the first order
+    // change of the eigenvectors, dgamma_n/dh2m
+    auto gamma = xt::xtensor<cmpl, 1>(std::array<size_t, 1>{n});
+    for (size_t m = 0; m < n; ++m) {
+      gamma(m) = 0.;
+      for (size_t i = 0; i < n; ++i)
+        gamma(m) += boundary(i) * Q(i, m);
+    }
+    auto FQ = xt::xtensor<cmpl, 2>({n, n});
+    auto QFQ = xt::xtensor<cmpl, 2>({n, n});
+    for (size_t i = 0; i < n; ++i)
+      for (size_t m = 0; m < n; ++m) {
+        cmpl sum = 0;
+        for (size_t j = 0; j < n; ++j)
+          sum += F(i, j) * Q(j, m);
+        FQ(i, m) = sum;
+      }
+    for (size_t k = 0; k < n; ++k)
+      for (size_t m = 0; m < n; ++m) {
+        cmpl sum = 0;
+        for (size_t i = 0; i < n; ++i)
+          sum += Q(i, k) * FQ(i, m);
+        QFQ(k, m) = sum;
+      }
+    const auto a2 = a * a;
+    for (size_t m = 0; m < n; ++m) {
+      cmpl dgamma = 0;
+      for (size_t k = 0; k < n; ++k)
+        if (k != m and eps(k) != eps(m))
+          dgamma += gamma(k) * QFQ(k, m) / (eps(m) - eps(k));
+      poles.energies(m) = to_MeV * eps(m);
+      poles.reduced_widths(m) = to_MeV * gamma(m) * gamma(m);
+      poles.energy_slopes(m) = QFQ(m, m) / a2;
+      poles.width_slopes(m) =
+          (gamma(m) * gamma(m) + 2. * gamma(m) * dgamma) / a2;
+    }
+    return poles;
+  }
+
+  /// @returns R-matrix, S-matrix and phase shift for a local potential
+  template <class T>
+  ScatteringMatrices matrices(const Channel &ch, const Channel::Energetics &e,
+                              const Channel::FermionSpinOrbitCoupling &am,
+                              const Potential<T> &v, T params) const {
+    const auto s = e.k * ch.radius;
+    return ScatteringMatrices(rmatrix(ch, e, am, v, params),
+                              ch.set_angular_momentum(am, e), s);
+  }
+
+  /// @returns R-matrix and S-matrix of an OMP with their derivatives with
+  /// respect to its 18 parameters, in the order of get_global_terms, by
+  /// forward propagation of tangents through the mesh solve. With C x = f the
+  /// boundary values, each tangent solves C dx_k = -dC_k x, and
+  /// dR_k = f^T dx_k; dC_k is diagonal, built from the analytic derivatives of
+  /// the form factors.
+  /// C is factorized once, by SymmetricLDLT whatever the kernel's backend, and
+  /// the factors serve x and all 18 tangents
+  /// @param params the 18 parameters of get_global_terms, or an OMPTerms
+  template <class T>
+  ScatteringDerivatives
+  derivatives(const Channel &ch, const Channel::Energetics &e,
+              const Channel::FermionSpinOrbitCoupling &am,
+              const T &params) const {
+    constexpr size_t nparams = 18;
+    const auto n = quadrature.size();
+    const auto a = ch.radius;
+    const auto s = e.k * a;
+    const auto scale = a / e.h2ma;
+    const auto ls = am.l_dot_s();
+    const auto terms = to_omp_terms(params);
+    const auto r = mesh(a);
+
+    auto v = std::vector<cmpl>(n);
+    auto dv = std::vector<cmpl>(nparams * n);
+    terms.evaluate(r.data(), n, ls, v.data());
+    terms.gradient(r.data(), n, ls, dv.data());
+
+    auto C = free_matrix(s, am.l);
+    for (size_t i = 0; i < n; ++i)
+      C(i, i) += scale * v[i];
+    const auto ldlt = SymmetricLDLT(C);
+    const auto x = ldlt.solve(xt::xtensor<cmpl, 1>(boundary));
+
+    auto tangents = xt::xtensor<cmpl, 2>({n, nparams});
+    for (size_t k = 0; k < nparams; ++k)
+      for (size_t i = 0; i < n; ++i)
+        tangents(i, k) = -scale * dv[k * n + i] * x(i);
+    const auto dx = ldlt.solve(tangents);
+
+    cmpl R = 0;
+    for (size_t i = 0; i < n; ++i)
+      R += boundary(i) * x(i);
+    const auto asym = ch.set_angular_momentum(am, e);
+    const auto dS_dR = ScatteringMatrices::dS_dR(R, asym, s);
+
+    auto result = ScatteringDerivatives{
+        ScatteringMatrices(R, asym, s),
+        xt::xtensor<cmpl, 1>(std::array<size_t, 1>{nparams}),
+        xt::xtensor<cmpl, 1>(std::array<size_t, 1>{nparams})};
+    for (size_t k = 0; k < nparams; ++k) {
+      result.dR(k) = 0;
+      for (size_t i = 0; i < n; ++i)
+        result.dR(k) += boundary(i) * dx(i, k);
+      result.dS(k) = dS_dR * result.dR(k);
+    }
+    return result;
+  }
+
+  /// @returns R-matrix and S-matrix of a local potential with their
+  /// sensitivities to the potential at each mesh point, by the adjoint method:
+  /// dR/dV(r_i) = -y^T dC/dV(r_i) x = -(a/h2ma) x_i^2, with C x = f and
+  /// C^T y = f. As C is complex symmetric, y = x, so the adjoint costs no
+  /// solve beyond the one for R itself, and the derivatives with respect to
+  /// any number of parameters follow from MeshSensitivities::derivatives at
+  /// O(nbasis) each
+  template <class T>
+  MeshSensitivities sensitivities(const Channel &ch,
+                                  const Channel::Energetics &e,
+                                  const Channel::FermionSpinOrbitCoupling &am,
+                                  const Potential<T> &v,
+                                  const T &params) const {
+    return mesh_sensitivities(ch, e, am, on_mesh(ch.radius, v, params));
+  }
+
+  /// @returns the same as derivatives, by the adjoint method: one solve for
+  /// the mesh sensitivities, contracted with the analytic derivatives of the
+  /// OMP form factors
+  /// @param params the 18 parameters of get_global_terms, or an OMPTerms
+  template <class T>
+  ScatteringDerivatives
+  adjoint_derivatives(const Channel &ch, const Channel::Energetics &e,
+                      const Channel::FermionSpinOrbitCoupling &am,
+                      const T &params) const {
+    constexpr size_t nparams = 18;
+    const auto n = quadrature.size();
+    const auto ls = am.l_dot_s();
+    const auto terms = to_omp_terms(params);
+    const auto r = mesh(ch.radius);
+
+    auto v = std::vector<cmpl>(n);
+    auto dv = std::vector<cmpl>(nparams * n);
+    terms.evaluate(r.data(), n, ls, v.data());
+    terms.gradient(r.data(), n, ls, dv.data());
+    return mesh_sensitivities(ch, e, am, v).derivatives(dv.data(), nparams);
+  }
+
+  /// @returns R-matrix, S-matrix and phase shift for every partial wave up to
+  /// lmax for an OMP, indexed first by Polarization: [up] holds j = l + 1/2 for
+  /// l = 0..lmax-1 and [down] holds j = l - 1/2 for l = 1..lmax-1. The central
+  /// and spin-orbit form factors are evaluated on the mesh once and shared by
+  /// all partial waves, as is one table of asymptotics
+  /// @param params the 18 parameters of get_global_terms, or an OMPTerms
+  /// @param cache if given, the asymptotic table is looked up in, or added
+  /// to, this cache, e.g. when the same energies are revisited for many
+  /// parameter samples; by default it is computed for this call only
+  template <class T>
+  std::array<std::vector<ScatteringMatrices>, 2>
+  partial_waves(const Channel &ch, const Channel::Energetics &e, const T &params,
+                int lmax = MAXL, AsymptoticsCache *cache = nullptr) const {
+    assert(lmax > 0 and lmax <= MAXL);
+    const auto n = quadrature.size();
+    const auto a = ch.radius;
+    const auto s = e.k * a;
+    const auto scale = a / e.h2ma;
+
+    const auto r = mesh(a);
+    auto central = std::vector<cmpl>(n);
+    auto spin_orbit = std::vector<cmpl>(n);
+    const auto terms = to_omp_terms(params);
+    terms.central(r.data(), n, central.data());
+    terms.spin_orbit(r.data(), n, spin_orbit.data());
+    for (size_t i = 0; i < n; ++i) {
+      central[i] *= scale;
+      spin_orbit[i] *= scale;
+    }
+
+    // boundary values of the free or Coulomb solutions are parameter
+    // independent
+    const auto asymptotics =
+        cache ? (*cache)(lmax, s, e.sommerfield_param)
+              : std::make_shared<const AsymptoticsCache::Table>(
+                    Channel::Asymptotics::generate_asymptotics(
+                        lmax, s, e.sommerfield_param));
+
+    const auto solve = [&](const Channel::FermionSpinOrbitCoupling &am) {
+      const auto ls = am.l_dot_s();
+      auto C = free_matrix(s, am.l);
+      for (size_t i = 0; i < n; ++i)
+        C(i, i) += central[i] + ls * spin_orbit[i];
+      return ScatteringMatrices(boundary_projection(C),
+                                AsymptoticsCache::row(*asymptotics, am.l), s);
+    };
+
+    std::array<std::vector<ScatteringMatrices>, 2> waves;
+    auto &up = waves[static_cast<int>(Polarization::up)];
+    auto &down = waves[static_cast<int>(Polarization::down)];
+    up.reserve(lmax);
+    down.reserve(lmax - 1);
+    for (int l = 0; l < lmax; ++l) {
+      up.push_back(solve(Channel::FermionSpinOrbitCoupling(2 * l + 2, l)));
+      if (l > 0)
+        down.push_back(solve(Channel::FermionSpinOrbitCoupling(2 * l, l)));
+    }
+    return waves;
+  }
+
+  /// @returns R-matrix, S-matrix and phase shift for a non-local potential
+  template <class T>
+  ScatteringMatrices matrices(const Channel &ch, const Channel::Energetics &e,
+                              const Channel::FermionSpinOrbitCoupling &am,
+                              const NonlocalPotential<T> &v, const T &params,
+                              int nthreads = 1) const {
+    const auto s = e.k * ch.radius;
+    return ScatteringMatrices(rmatrix(ch, e, am, v, params, nthreads),
+                              ch.set_angular_momentum(am, e), s);
+  }
+
+  /// @returns R-matrix and S-matrix between nchannels local channels coupled
+  /// by a ChannelCoupling, at a CMS energy measured from the threshold of the
+  /// ground state. All channels must be open and share the channel radius.
+  ///
+  /// The mesh matrix has dense diagonal blocks and off-diagonal blocks only
+  /// for coupled channels. Rather than assembling and factorizing the full
+  /// (nchannels * nbasis)^2 system, channels are eliminated one at a time
+  /// (block LDL^T), keeping only the blocks that are coupled or filled in,
+  /// coupling blocks as their diagonals until they are filled in, and
+  /// the boundary projections f^T C^-1 f are accumulated as the Schur
+  /// complement of the system augmented by the channel surface functions
+  template <class T>
+  CoupledScatteringMatrices
+  coupled_matrices(const std::vector<Channel> &channels, real erg_cms,
+                   const std::vector<Channel::FermionSpinOrbitCoupling> &am,
+                   const std::vector<const Potential<T> *> &potentials,
+                   const std::vector<T> &params,
+                   const ChannelCoupling<T> &coupling) const {
+    const auto nc = channels.size();
+    const auto n = quadrature.size();
+    assert(nc == static_cast<size_t>(nchannels));
+    assert(am.size() == nc and potentials.size() == nc and
+           params.size() == nc);
+    const auto a = channels.front().radius;
+
+    auto ergs = std::vector<Channel::Energetics>{};
+    // hbar^2/(2 mu) [MeV fm^2]
+    auto h2m = std::vector<real>(nc);
+    for (size_t c = 0; c < nc; ++c) {
+      assert(channels[c].radius == a);
+      ergs.push_back(channels[c].set_erg_cms(erg_cms));
+      assert(ergs[c].erg_cms > 0);
+      h2m[c] = ergs[c].h2ma * a;
+    }
+
+    // diagonal blocks [MeV]
+    auto diag = std::vector<xt::xtensor<cmpl, 2>>{};
+    for (size_t c = 0; c < nc; ++c) {
+      const auto to_MeV = h2m[c] / (a * a);
+      auto D = free_matrix(ergs[c].k * a, am[c].l);
+      for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j)
+          D(i, j) *= to_MeV;
+      const auto vr = on_mesh(a, *potentials[c], params[c]);
+      for (size_t i = 0; i < n; ++i)
+        D(i, i) += vr[i];
+      diag.push_back(std::move(D));
+    }
+
+    // upper off-diagonal blocks (c < c') [MeV]; absent blocks are zero
+    const auto form_factor =
+        on_mesh(a, coupling.form_factor, coupling.params);
+    auto offdiag = std::map<std::pair<size_t, size_t>, CouplingBlock>{};
+    for (size_t c = 0; c < nc; ++c) {
+      for (size_t cp = c + 1; cp < nc; ++cp) {
+        assert(coupling.strengths(c, cp) == coupling.strengths(cp, c));
+        if (coupling.strengths(c, cp) == 0.)
+          continue;
+        auto d = std::vector<cmpl>(n);
+        for (size_t i = 0; i < n; ++i)
+          d[i] = coupling.strengths(c, cp) * form_factor[i];
+        offdiag.emplace(std::make_pair(c, cp), CouplingBlock{std::move(d), {}});
+      }
+    }
+
+    // rows of each channel against the boundary columns of the augmented
+    // system, f in the rows of its own channel
+    auto surface = std::vector<xt::xtensor<cmpl, 2>>{};
+    for (size_t c = 0; c < nc; ++c) {
+      auto W = xt::xtensor<cmpl, 2>(xt::zeros<cmpl>({n, nc}));
+      for (size_t i = 0; i < n; ++i)
+        W(i, c) = boundary(i);
+      surface.push_back(std::move(W));
+    }
+
+    // f^T C^-1 f [MeV^-1]
+    auto G = xt::xtensor<cmpl, 2>(xt::zeros<cmpl>({nc, nc}));
+
+    for (size_t c = 0; c < nc; ++c) {
+      auto neighbors = std::vector<size_t>{};
+      for (auto it = offdiag.lower_bound({c, 0});
+           it != offdiag.end() and it->first.first == c; ++it)
+        neighbors.push_back(it->first.second);
+
+      // solve against the boundary columns and every coupling block at once
+      auto rhs = xt::xtensor<cmpl, 2>(
+          xt::zeros<cmpl>({n, nc + neighbors.size() * n}));
+      for (size_t i = 0; i < n; ++i)
+        for (size_t p = 0; p < nc; ++p)
+          rhs(i, p) = surface[c](i, p);
+      for (size_t q = 0; q < neighbors.size(); ++q) {
+        const auto &B = offdiag.at({c, neighbors[q]});
+        const auto col = nc + q * n;
+        if (B.is_dense()) {
+          for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j)
+              rhs(i, col + j) = B.dense(i, j);
+        } else {
+          for (size_t i = 0; i < n; ++i)
+            rhs(i, col + i) = B.diagonal[i];
+        }
+      }
+      const auto Y = solve_block(diag[c], rhs);
+
+      for (size_t p = 0; p < nc; ++p)
+        for (size_t pp = 0; pp < nc; ++pp)
+          for (size_t i = 0; i < n; ++i)
+            G(p, pp) += surface[c](i, p) * Y(i, pp);
+
+      for (size_t q = 0; q < neighbors.size(); ++q) {
+        const auto cq = neighbors[q];
+        const auto &Bq = offdiag.at({c, cq});
+
+        // B_q^T Y restricted to the columns [col, col + ncol); O(n ncol) for
+        // a diagonal block, O(n^2 ncol) once it has been filled in
+        const auto subtract_BqT_Y = [&](xt::xtensor<cmpl, 2> &target,
+                                        size_t col, size_t ncol) {
+          if (Bq.is_dense()) {
+            for (size_t i = 0; i < n; ++i)
+              for (size_t j = 0; j < ncol; ++j)
+                for (size_t k = 0; k < n; ++k)
+                  target(i, j) -= Bq.dense(k, i) * Y(k, col + j);
+          } else {
+            for (size_t i = 0; i < n; ++i)
+              for (size_t j = 0; j < ncol; ++j)
+                target(i, j) -= Bq.diagonal[i] * Y(i, col + j);
+          }
+        };
+
+        subtract_BqT_Y(surface[cq], 0, nc);
+
+        // Schur complement, B_q^T D^-1 B_r, onto the remaining channels; the
+        // product is dense, so the target block is filled in
+        for (size_t r = q; r < neighbors.size(); ++r) {
+          const auto cr = neighbors[r];
+          auto &target = cq == cr ? diag[cq] : offdiag[{cq, cr}].densify(n);
+          subtract_BqT_Y(target, nc + r * n, n);
+        }
+      }
+
+      for (const auto cq : neighbors)
+        offdiag.erase({c, cq});
+    }
+
+    auto result = CoupledScatteringMatrices{
+        xt::xtensor<cmpl, 2>({nc, nc}), xt::xtensor<cmpl, 2>({nc, nc})};
+    for (size_t c = 0; c < nc; ++c)
+      for (size_t cp = 0; cp < nc; ++cp)
+        result.R(c, cp) = sqrt(h2m[c] * h2m[cp]) / (a * a) * G(c, cp);
+
+    // S = Z_O^-1 Z_I, Z = H - s^(1/2) R s^(1/2) H'
+    auto asym = std::vector<Channel::Asymptotics>{};
+    for (size_t c = 0; c < nc; ++c)
+      asym.push_back(channels[c].set_angular_momentum(am[c], ergs[c]));
+    auto Z_out = xt::xtensor<cmpl, 2>({nc, nc});
+    auto Z_in = xt::xtensor<cmpl, 2>({nc, nc});
+    for (size_t c = 0; c < nc; ++c) {
+      for (size_t cp = 0; cp < nc; ++cp) {
+        const auto Rs = sqrt(ergs[c].k * ergs[cp].k) * a * result.R(c, cp);
+        Z_out(c, cp) = -Rs * asym[cp].wvfxn_deriv_out;
+        Z_in(c, cp) = -Rs * asym[cp].wvfxn_deriv_in;
+      }
+      Z_out(c, c) += asym[c].wvfxn_out;
+      Z_in(c, c) += asym[c].wvfxn_in;
+    }
+    result.S = xt::linalg::solve(Z_out, Z_in);
+    return result;
+  }
+
+  /// @returns the indices into ergs_cms at which an energy sweep with
+  /// relative reduced-mass tolerance mu_rtol diagonalizes the mesh
+  /// Hamiltonian: the first energy, and every energy whose hbar^2/(2 mu)
+  /// differs from that of the last diagonalization by more than mu_rtol
+  static std::vector<size_t> sweep_rebuilds(const Channel &ch,
+                                            const std::vector<real> &ergs_cms,
+                                            real mu_rtol) {
+    auto rebuilds = std::vector<size_t>{};
+    real h2m_built = 0;
+    for (size_t i = 0; i < ergs_cms.size(); ++i) {
+      const auto h2m = ch.set_erg_cms(ergs_cms[i]).h2ma * ch.radius;
+      if (rebuilds.empty() or fabs(h2m - h2m_built) > mu_rtol * h2m_built) {
+        rebuilds.push_back(i);
+        h2m_built = h2m;
+      }
+    }
+    return rebuilds;
+  }
+
+  /// @returns R-matrix, S-matrix and phase shift on a grid of CMS energies for
+  /// a local, energy-independent potential. The mesh Hamiltonian is
+  /// diagonalized at the first energy of the grid and each energy is then a
+  /// pole sum, its poles and widths corrected to first order for the drift of
+  /// the relativistic reduced mass. The error of that correction is of order
+  /// (relative drift)^2, so the Hamiltonian is only rediagonalized when the
+  /// drift exceeds mu_rtol; see sweep_rebuilds. mu_rtol = 0 rediagonalizes at
+  /// every energy, reproducing the per-energy matrices(). For a nucleon mu
+  /// drifts by about 1e-3 per MeV, so the default rediagonalizes about once
+  /// per MeV of the grid, however fine, with errors in S of a few 1e-5
+  template <class T>
+  std::vector<ScatteringMatrices>
+  matrices(const Channel &ch, const std::vector<real> &ergs_cms,
+           const Channel::FermionSpinOrbitCoupling &am, const Potential<T> &v,
+           T params, real mu_rtol = 1e-3) const {
+    assert(not ergs_cms.empty());
+    const auto rebuilds = sweep_rebuilds(ch, ergs_cms, mu_rtol);
+    auto next = rebuilds.begin();
+    auto pole_sum = std::optional<RMatrixPoles>{};
+    auto result = std::vector<ScatteringMatrices>{};
+    result.reserve(ergs_cms.size());
+    for (size_t i = 0; i < ergs_cms.size(); ++i) {
+      const auto e = ch.set_erg_cms(ergs_cms[i]);
+      if (next != rebuilds.end() and *next == i) {
+        pole_sum = poles(ch, e, am, v, params);
+        ++next;
+      }
+      const auto h2m = e.h2ma * ch.radius;
+      result.emplace_back((*pole_sum)(h2m * e.k * e.k, h2m),
+                          ch.set_angular_momentum(am, e), e.k * ch.radius);
+    }
+    return result;
+  }
 };
 
 } // namespace osiris
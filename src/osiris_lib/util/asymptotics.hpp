@@ -2,11 +2,19 @@
 #ifndef ASYMPTOTICS_HEADER
 #define ASYMPTOTICS_HEADER
 
+#include "util/config.hpp"
 #include "util/constants.hpp"
 #include "util/types.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <cmath>
 #include <complex>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace osiris {
 
@@ -58,6 +66,314 @@ struct d_dz {
     return f(z) * static_cast<cmpl>(1 + l) / z - ReducedSphBessel{l + 1}(z);
   }
 };
+
+/// @brief reduced spherical Bessel functions F_l, G_l and their derivatives
+/// in z, for all l = 0..lmax-1 in one pass. G_l is built by upward recurrence,
+/// f_(l+1) = (2l+1)/z f_l - f_(l-1), which is stable for the irregular
+/// solution. F_l is built by Miller's downward recurrence from well above
+/// max(lmax, z), rescaled to avoid overflow and normalized with the Wronskian
+/// F_(l-1) G_l - F_l G_(l-1) = 1. Derivatives follow from
+/// f'_l = f_(l-1) - l f_l/z, with F_(-1) = cos(z) and G_(-1) = -sin(z).
+/// Storage is fixed at MAXL partial waves; see F and G for higher l
+struct RiccatiBessel {
+  int lmax;
+  std::array<real, MAXL> F{};
+  std::array<real, MAXL> G{};
+  std::array<real, MAXL> dF{};
+  std::array<real, MAXL> dG{};
+
+  /// @throws std::runtime_error if lmax > MAXL
+  RiccatiBessel(int lmax, real z) : lmax(lmax) {
+    assert(lmax > 0);
+    assert(z > 0);
+    if (lmax > MAXL)
+      throw std::runtime_error("RiccatiBessel: lmax exceeds MAXL");
+    const auto sin_z = sin(z);
+    const auto cos_z = cos(z);
+
+    // G_l upward
+    real g_prev = -sin_z;
+    G[0] = cos_z;
+    for (int l = 1; l < lmax; ++l) {
+      const auto g = (2 * l - 1) / z * G[l - 1] - g_prev;
+      g_prev = G[l - 1];
+      G[l] = g;
+    }
+    const auto G1 = lmax > 1 ? G[1] : cos_z / z + sin_z;
+
+    // F_l downward, starting from an arbitrary small value
+    constexpr real big = 1e200;
+    const int lstart = lmax + static_cast<int>(z) + 30;
+    real f_next = 0;
+    real f = 1e-300;
+    real f1 = 0;
+    for (int l = lstart; l > 0; --l) {
+      const auto f_prev = (2 * l + 1) / z * f - f_next;
+      f_next = f;
+      f = f_prev;
+      if (l - 1 < lmax)
+        F[l - 1] = f;
+      if (l - 1 == 1)
+        f1 = f;
+      if (fabs(f) > big) {
+        f /= big;
+        f_next /= big;
+        f1 /= big;
+        for (int k = l - 1; k < lmax; ++k)
+          F[k] /= big;
+      }
+    }
+    if (lmax == 1)
+      f1 = f_next;
+    const auto wronskian = F[0] * G1 - f1 * G[0];
+    for (int l = 0; l < lmax; ++l)
+      F[l] /= wronskian;
+
+    dF[0] = cos_z;
+    dG[0] = -sin_z;
+    for (int l = 1; l < lmax; ++l) {
+      dF[l] = F[l - 1] - l * F[l] / z;
+      dG[l] = G[l - 1] - l * G[l] / z;
+    }
+  }
+
+  /// @returns reduced spherical Hankel function; outgoing
+  cmpl h_plus(int l) const { return {G[l], F[l]}; }
+  /// @returns reduced spherical Hankel function; incoming
+  cmpl h_minus(int l) const { return {G[l], -F[l]}; }
+  /// @returns derivative in z of the outgoing Hankel function
+  cmpl h_plus_deriv(int l) const { return {dG[l], dF[l]}; }
+  /// @returns derivative in z of the incoming Hankel function
+  cmpl h_minus_deriv(int l) const { return {dG[l], -dF[l]}; }
+};
+
+/// @returns Coulomb phase shifts sigma_l = arg Gamma(l + 1 + i eta) for
+/// l = 0..lmax-1. sigma_0 comes from Stirling's series for Gamma(1 + N + i eta),
+/// shifted down to N = 0 by arg(z + k) = atan(eta/(1 + k)), and the rest from
+/// sigma_l = sigma_(l-1) + atan(eta/l)
+inline std::vector<real> coulomb_phases(int lmax, real eta) {
+  assert(lmax > 0);
+  constexpr int shift = 10;
+  const auto w = cmpl{1. + shift, eta};
+  const auto w2 = w * w;
+  const auto ln_gamma =
+      (w - 0.5) * std::log(w) - w + 0.5 * std::log(2 * constants::pi) +
+      (1. / 12. - (1. / 360. - (1. / 1260. - 1. / (1680. * w2)) / w2) / w2) /
+          w;
+  auto sigma = std::vector<real>(lmax);
+  sigma[0] = ln_gamma.imag();
+  for (int k = 0; k < shift; ++k)
+    sigma[0] -= atan(eta / (1. + k));
+  for (int l = 1; l < lmax; ++l)
+    sigma[l] = sigma[l - 1] + atan(eta / l);
+  return sigma;
+}
+
+/// @brief regular and irregular Coulomb functions F_l(eta, z), G_l(eta, z),
+/// their derivatives in z, and the Coulomb phases sigma_l, for all
+/// l = 0..lmax-1 in one pass, by Steed's method as in COULFG/COUL90:
+/// Barnett, A. R. "The calculation of spherical Bessel and Coulomb functions."
+/// Computational Atomic Physics. Springer, 1996. 181-202.
+///
+/// CF1 gives F'/F at the highest l, from which F_l is recurred downward up to
+/// normalization. CF2 gives H'/H = p + iq at l = 0, H = G + iF, which together
+/// with the Wronskian F'G - FG' = 1 fixes the normalization and G_0. G_l is
+/// then recurred upward. The recurrences use R_l = sqrt(1 + eta^2/l^2) and
+/// S_l = l/z + eta/l:
+///   R_l u_(l-1) = S_l u_l + u'_l,   u'_l = R_l u_(l-1) - S_l u_l
+/// Reduces to RiccatiBessel for eta = 0.
+///
+/// Inside the turning point of l = 0, z < 2 eta, F_0 << G_0 and the
+/// normalization from CF2 loses all precision. There G_0 is instead taken at
+/// the turning point and integrated inward, where it is the dominant
+/// solution, and F_0 follows from CF1 and the Wronskian.
+/// @throws std::runtime_error if CF1 or CF2 fails to converge
+struct Coulomb {
+  int lmax;
+  real eta;
+  std::vector<real> F;
+  std::vector<real> G;
+  std::vector<real> dF;
+  std::vector<real> dG;
+  std::vector<real> sigma;
+
+  Coulomb(int lmax, real eta, real z)
+      : lmax(lmax), eta(eta), F(lmax), G(lmax), dF(lmax), dG(lmax),
+        sigma(coulomb_phases(lmax, eta)) {
+    assert(lmax > 0);
+    assert(z > 0);
+    const auto zinv = 1. / z;
+    const auto ltop = lmax - 1;
+
+    // CF1: f = F'_ltop / F_ltop, by modified Lentz; fsign tracks the sign of
+    // F_ltop. Convergence takes of order z iterations
+    real pk = ltop + 1;
+    real f = eta / pk + pk * zinv;
+    if (fabs(f) < fpmin)
+      f = fpmin;
+    real c = f;
+    real d = 0;
+    real fsign = 1;
+    const auto max_iterations = 20000 + 2 * (z + fabs(eta));
+    bool converged = false;
+    for (int iter = 0; iter < max_iterations and !converged; ++iter) {
+      const auto pk1 = pk + 1;
+      const auto ek = eta / pk;
+      const auto rk2 = 1 + ek * ek;
+      const auto tk = (pk + pk1) * (zinv + ek / pk1);
+      d = tk - rk2 * d;
+      c = tk - rk2 / c;
+      if (fabs(c) < fpmin)
+        c = fpmin;
+      if (fabs(d) < fpmin)
+        d = fpmin;
+      d = 1. / d;
+      const auto df = d * c;
+      f *= df;
+      if (d < 0)
+        fsign = -fsign;
+      pk = pk1;
+      converged = fabs(df - 1) < accuracy;
+    }
+    if (!converged)
+      throw std::runtime_error("Coulomb: CF1 did not converge");
+
+    // unnormalized F_l downward from ltop
+    real fl = fsign;
+    real dfl = fsign * f;
+    F[ltop] = fl;
+    dF[ltop] = dfl;
+    for (int l = ltop; l > 0; --l) {
+      const auto el = eta / l;
+      const auto rl = sqrt(1 + el * el);
+      const auto sl = el + l * zinv;
+      const auto fl1 = (fl * sl + dfl) / rl;
+      dfl = fl1 * sl - fl * rl;
+      fl = fl1;
+      F[l - 1] = fl;
+      dF[l - 1] = dfl;
+      if (fabs(fl) > 1e200) {
+        for (int k = l - 1; k <= ltop; ++k) {
+          F[k] *= 1e-200;
+          dF[k] *= 1e-200;
+        }
+        fl *= 1e-200;
+        dfl *= 1e-200;
+      }
+    }
+    const auto f0 = dF[0] / F[0];
+
+    // normalize with the Wronskian
+    real F0;
+    if (z < 2 * eta) {
+      std::tie(G[0], dG[0]) = irregular_inside_turning_point(eta, z);
+      F0 = 1. / (f0 * G[0] - dG[0]);
+    } else {
+      const auto [p, q] = cf2(eta, z);
+      const auto gamma = (f0 - p) / q;
+      F0 = std::copysign(1. / sqrt((f0 - p) * gamma + q), F[0]);
+      // G_0 = gamma F_0, G'_0 = p G_0 - q F_0
+      G[0] = gamma * F0;
+      dG[0] = p * G[0] - q * F0;
+    }
+    const auto w = F0 / F[0];
+    for (int l = 0; l <= ltop; ++l) {
+      F[l] *= w;
+      dF[l] *= w;
+    }
+
+    // G_l upward from G_0
+    for (int l = 1; l <= ltop; ++l) {
+      const auto el = eta / l;
+      const auto rl = sqrt(1 + el * el);
+      const auto sl = el + l * zinv;
+      G[l] = (sl * G[l - 1] - dG[l - 1]) / rl;
+      dG[l] = rl * G[l - 1] - sl * G[l];
+    }
+  }
+
+  /// @returns outgoing Coulomb function H+ = G + iF
+  cmpl h_plus(int l) const { return {G[l], F[l]}; }
+  /// @returns incoming Coulomb function H- = G - iF
+  cmpl h_minus(int l) const { return {G[l], -F[l]}; }
+  /// @returns derivative in z of the outgoing Coulomb function
+  cmpl h_plus_deriv(int l) const { return {dG[l], dF[l]}; }
+  /// @returns derivative in z of the incoming Coulomb function
+  cmpl h_minus_deriv(int l) const { return {dG[l], -dF[l]}; }
+
+private:
+  static constexpr real accuracy = 1e-15;
+  static constexpr real fpmin = 1e-300;
+
+  /// @returns p + iq = H'_0 / H_0 by Steed's algorithm. Convergence takes
+  /// of order 10/z iterations for small z
+  static std::pair<real, real> cf2(real eta, real z) {
+    const auto zinv = 1. / z;
+    real p = 0;
+    real q = 1 - eta * zinv;
+    real ar = -eta * eta;
+    real ai = eta;
+    const auto br = 2 * (z - eta);
+    real bi = 2;
+    real dr = br / (br * br + bi * bi);
+    real di = -bi / (br * br + bi * bi);
+    real dp = -zinv * (ar * di + ai * dr);
+    real dq = zinv * (ar * dr - ai * di);
+    real pk = 0;
+    const auto max_iterations = 20000 + 100 * zinv;
+    for (int iter = 0; iter < max_iterations; ++iter) {
+      p += dp;
+      q += dq;
+      pk += 2;
+      ar += pk;
+      ai += 2 * eta;
+      bi += 2;
+      const auto d = ar * dr - ai * di + br;
+      di = ai * dr + ar * di + bi;
+      const auto c = 1. / (d * d + di * di);
+      dr = c * d;
+      di = -c * di;
+      const auto a = br * dr - bi * di - 1;
+      const auto b = bi * dr + br * di;
+      const auto dp1 = dp * a - dq * b;
+      dq = dp * b + dq * a;
+      dp = dp1;
+      if (fabs(dp) + fabs(dq) < (fabs(p) + fabs(q)) * accuracy)
+        return {p, q};
+    }
+    throw std::runtime_error("Coulomb: CF2 did not converge");
+  }
+
+  /// @returns G_0 and G'_0 at z < 2 eta, by RK4 integration of
+  /// u'' = (2 eta/z - 1) u inward from the turning point. The step resolves
+  /// both the local wavenumber and the 1/z singularity
+  static std::pair<real, real> irregular_inside_turning_point(real eta,
+                                                              real z) {
+    constexpr real step = 0.005;
+    const auto turning_point = Coulomb(1, eta, 2 * eta);
+    real u = turning_point.G[0];
+    real du = turning_point.dG[0];
+    const auto rhs = [eta](real r, real u) { return (2 * eta / r - 1) * u; };
+    real r = 2 * eta;
+    while (r > z) {
+      const auto kappa = sqrt(std::max(1., 2 * eta / r - 1));
+      const auto h = -std::min(r - z, step * std::min(r, 1. / kappa));
+      const auto k1u = du;
+      const auto k1d = rhs(r, u);
+      const auto k2u = du + 0.5 * h * k1d;
+      const auto k2d = rhs(r + 0.5 * h, u + 0.5 * h * k1u);
+      const auto k3u = du + 0.5 * h * k2d;
+      const auto k3d = rhs(r + 0.5 * h, u + 0.5 * h * k2u);
+      const auto k4u = du + h * k3d;
+      const auto k4d = rhs(r + h, u + h * k3u);
+      u += h / 6 * (k1u + 2 * k2u + 2 * k3u + k4u);
+      du += h / 6 * (k1d + 2 * k2d + 2 * k3d + k4d);
+      r += h;
+    }
+    return {u, du};
+  }
+};
+
 } // namespace asymptotics
 } // namespace osiris
 #endif
@@ -1,8 +1,14 @@
+#include "solver/asymptotics_cache.hpp"
 #include "solver/channel.hpp"
 
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
 using Catch::Approx;
 
 TEST_CASE("Build channel at varying energy") {
@@ -80,3 +86,197 @@ TEST_CASE("Build channel at varying energy") {
     REQUIRE(asym.wvfxn_deriv_out.imag() == Approx(0.9619511098235556));
   }
 }
+
+TEST_CASE("Batched Riccati-Bessel recurrences") {
+  using namespace osiris;
+
+  for (const auto z : {0.3, 2.627, 12., 35.}) {
+    const auto rb = asymptotics::RiccatiBessel(MAXL, z);
+    for (int l = 0; l < MAXL; ++l) {
+      REQUIRE(rb.F[l] == Approx(asymptotics::F{l}(z)).epsilon(1e-10));
+      REQUIRE(rb.G[l] == Approx(asymptotics::G{l}(z)).epsilon(1e-10));
+      REQUIRE(rb.dF[l] ==
+              Approx(asymptotics::d_dz(asymptotics::F{l})(z).real())
+                  .epsilon(1e-10));
+      REQUIRE(rb.dG[l] ==
+              Approx(asymptotics::d_dz(asymptotics::G{l})(z).real())
+                  .epsilon(1e-10));
+    }
+  }
+}
+
+TEST_CASE("Asymptotics beyond the recurrence storage") {
+  using namespace osiris;
+  using Asymptotics = Channel::Asymptotics;
+
+  // ka ~ 45 at 200 MeV on heavy targets needs l >= MAXL
+  const real s = 45.;
+  REQUIRE_THROWS_AS(asymptotics::RiccatiBessel(MAXL + 1, s),
+                    std::runtime_error);
+  const int lmax = MAXL + 15;
+  const auto table = Asymptotics::generate_asymptotics(lmax, s);
+  REQUIRE(table.shape()[0] == static_cast<size_t>(lmax));
+  for (const int l : {0, MAXL - 1, MAXL, MAXL + 14}) {
+    const auto a = Asymptotics(l, s);
+    const auto h = asymptotics::h_plus{l}(s);
+    const auto dh = asymptotics::d_dz(asymptotics::h_plus{l})(s);
+    REQUIRE(a.wvfxn_out.real() == Approx(h.real()).epsilon(1e-10));
+    REQUIRE(a.wvfxn_out.imag() == Approx(h.imag()).epsilon(1e-10));
+    REQUIRE(a.wvfxn_in.imag() == Approx(-h.imag()).epsilon(1e-10));
+    REQUIRE(a.wvfxn_deriv_out.real() == Approx(dh.real()).epsilon(1e-10));
+    REQUIRE(a.wvfxn_deriv_in.imag() == Approx(-dh.imag()).epsilon(1e-10));
+    REQUIRE(table(l, 0).real() == Approx(h.real()).epsilon(1e-10));
+    REQUIRE(table(l, 2).imag() == Approx(dh.imag()).epsilon(1e-10));
+  }
+}
+
+TEST_CASE("Coulomb functions") {
+  using namespace osiris;
+
+  SECTION("reduce to Riccati-Bessel functions without charge") {
+    const auto z = 7.3;
+    const auto rb = asymptotics::RiccatiBessel(MAXL, z);
+    const auto cf = asymptotics::Coulomb(MAXL, 0., z);
+    for (int l = 0; l < MAXL; ++l) {
+      REQUIRE(cf.F[l] == Approx(rb.F[l]).epsilon(1e-10));
+      REQUIRE(cf.G[l] == Approx(rb.G[l]).epsilon(1e-10));
+      REQUIRE(cf.dG[l] == Approx(rb.dG[l]).epsilon(1e-10));
+      REQUIRE(cf.sigma[l] == 0.);
+    }
+  }
+
+  SECTION("Wronskian and asymptotic phase") {
+    // the phase neglects corrections of order (l(l+1) + eta^2)/(2 z)
+    const auto eta = 0.8;
+    const auto z = 5e4;
+    const auto cf = asymptotics::Coulomb(6, eta, z);
+    for (int l = 0; l < 6; ++l) {
+      REQUIRE(cf.dF[l] * cf.G[l] - cf.F[l] * cf.dG[l] == Approx(1.));
+      const auto theta =
+          z - eta * log(2 * z) - l * constants::pi / 2 + cf.sigma[l];
+      REQUIRE(cf.F[l] == Approx(sin(theta)).margin(1e-3));
+      REQUIRE(cf.G[l] == Approx(cos(theta)).margin(1e-3));
+    }
+  }
+
+  SECTION("solve the Coulomb equation") {
+    // integrate u'' = (l(l+1)/z^2 + 2 eta/z - 1) u from z0 to z1 by RK4
+    const auto eta = 1.3;
+    const int l = 3;
+    const auto z0 = 8.;
+    const auto z1 = 14.;
+    const auto start = asymptotics::Coulomb(l + 1, eta, z0);
+    const auto end = asymptotics::Coulomb(l + 1, eta, z1);
+    const auto rhs = [&](real z, real u) {
+      return (l * (l + 1) / (z * z) + 2 * eta / z - 1) * u;
+    };
+    for (const auto [u0, du0, u1] :
+         {std::array<real, 3>{start.F[l], start.dF[l], end.F[l]},
+          std::array<real, 3>{start.G[l], start.dG[l], end.G[l]}}) {
+      real u = u0;
+      real du = du0;
+      const int steps = 6000;
+      const auto h = (z1 - z0) / steps;
+      for (int i = 0; i < steps; ++i) {
+        const auto z = z0 + i * h;
+        const auto k1u = du;
+        const auto k1d = rhs(z, u);
+        const auto k2u = du + 0.5 * h * k1d;
+        const auto k2d = rhs(z + 0.5 * h, u + 0.5 * h * k1u);
+        const auto k3u = du + 0.5 * h * k2d;
+        const auto k3d = rhs(z + 0.5 * h, u + 0.5 * h * k2u);
+        const auto k4u = du + h * k3d;
+        const auto k4d = rhs(z + h, u + h * k3u);
+        u += h / 6 * (k1u + 2 * k2u + 2 * k3u + k4u);
+        du += h / 6 * (k1d + 2 * k2d + 2 * k3d + k4d);
+      }
+      REQUIRE(u == Approx(u1).epsilon(1e-8));
+    }
+  }
+
+  SECTION("inside the turning point") {
+    // z < 2 eta, reference values from mpmath coulombf/coulombg
+    const auto low = asymptotics::Coulomb(1, 14.5, 3.3);
+    REQUIRE(low.F[0] == Approx(1.03974224686e-12).epsilon(1e-8));
+    REQUIRE(low.G[0] == Approx(1.72150234448e11).epsilon(1e-8));
+
+    // storage is sized at runtime, beyond MAXL
+    const int lmax = 41;
+    const auto cf = asymptotics::Coulomb(lmax, 20., 5.);
+    REQUIRE(cf.F[0] == Approx(1.64766608021e-16).epsilon(1e-8));
+    REQUIRE(cf.G[0] == Approx(1.146433584e15).epsilon(1e-8));
+    REQUIRE(cf.F[3] == Approx(7.36990990233e-17).epsilon(1e-8));
+    REQUIRE(cf.G[3] == Approx(2.47938901663e15).epsilon(1e-8));
+    REQUIRE(cf.F[40] == Approx(1.3177366081e-47).epsilon(1e-8));
+    REQUIRE(cf.G[40] == Approx(4.45288811429e45).epsilon(1e-8));
+    for (int l = 0; l < lmax; ++l)
+      REQUIRE(cf.dF[l] * cf.G[l] - cf.F[l] * cf.dG[l] == Approx(1.));
+  }
+
+  SECTION("report non-convergence") {
+    const auto nan = std::numeric_limits<real>::quiet_NaN();
+    REQUIRE_THROWS_AS(asymptotics::Coulomb(1, nan, 5.), std::runtime_error);
+  }
+
+  SECTION("Coulomb phases") {
+    // sigma_0 = arg Gamma(1 + i eta); for eta = 1, -0.30164032046...
+    const auto sigma = asymptotics::coulomb_phases(3, 1.);
+    REQUIRE(sigma[0] == Approx(-0.3016403205));
+    REQUIRE(sigma[2] == Approx(sigma[0] + atan(1.) + atan(0.5)));
+  }
+}
+
+TEST_CASE("Asymptotics cache") {
+  using namespace osiris;
+
+  auto cache = AsymptoticsCache{};
+  const auto chn = Channel(0., 12., constants::n_mass_amu, 0, 2, 139., 54);
+  const auto e = chn.set_erg_cms(1.0);
+  const auto s = e.k * chn.radius;
+
+  const auto table = cache(MAXL, s);
+  REQUIRE(cache.size() == 1);
+  REQUIRE(cache(MAXL, s) == table);
+  REQUIRE(cache.size() == 1);
+
+  const auto reference = Channel::Asymptotics::generate_asymptotics(MAXL, s);
+  for (int l = 0; l < MAXL; ++l)
+    for (int j = 0; j < 4; ++j)
+      REQUIRE((*table)(l, j) == reference(l, j));
+
+  const auto am = Channel::FermionSpinOrbitCoupling(4, 1);
+  const auto asym = cache(chn, e, am);
+  const auto direct = chn.set_angular_momentum(am, e.k);
+  REQUIRE(asym.wvfxn_out.real() == Approx(direct.wvfxn_out.real()));
+  REQUIRE(asym.wvfxn_deriv_in.imag() == Approx(direct.wvfxn_deriv_in.imag()));
+  REQUIRE(cache.size() == 1);
+
+  // concurrent queries on a shared grid of energies
+  auto workers = std::vector<std::thread>{};
+  for (int t = 0; t < 4; ++t)
+    workers.emplace_back([&cache, &chn]() {
+      for (int i = 1; i <= 20; ++i)
+        cache(10, chn.set_erg_cms(0.5 * i).k * chn.radius);
+    });
+  for (auto &w : workers)
+    w.join();
+  REQUIRE(cache.size() == 21);
+
+  cache.clear();
+  REQUIRE(cache.size() == 0);
+  REQUIRE((*table)(0, 0) == reference(0, 0));
+
+  // least recently used tables are evicted beyond capacity
+  auto bounded = AsymptoticsCache(3);
+  REQUIRE(bounded.max_size() == 3);
+  const auto first = bounded(MAXL, 1.);
+  const auto second = bounded(MAXL, 2.);
+  bounded(MAXL, 3.);
+  REQUIRE(bounded(MAXL, 1.) == first);
+  bounded(MAXL, 4.);
+  REQUIRE(bounded.size() == 3);
+  REQUIRE(bounded(MAXL, 1.) == first);
+  REQUIRE(bounded(MAXL, 2.) != second);
+  REQUIRE((*second)(0, 0) == (*bounded(MAXL, 2.))(0, 0));
+  REQUIRE(bounded.size() == 3);
+}
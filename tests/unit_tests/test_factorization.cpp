@@ -0,0 +1,130 @@
+#include "solver/factorization.hpp"
+#include "util/types.hpp"
+
+#include "xtensor-blas/xlinalg.hpp"
+#include "xtensor/xtensor.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
+
+using namespace osiris;
+
+using Catch::Approx;
+
+namespace {
+/// @brief complex symmetric test matrix with a small diagonal, which forces
+/// 2x2 pivots, and an absorptive part like an optical potential
+template <size_t N> std::array<cmpl, N * N> test_matrix() {
+  auto A = std::array<cmpl, N * N>{};
+  for (size_t j = 0; j < N; ++j) {
+    for (size_t i = 0; i < N; ++i) {
+      const auto x = static_cast<real>(i + 1);
+      const auto y = static_cast<real>(j + 1);
+      A[i + j * N] = cmpl{sin(x * y) / (x + y), 0.1 * cos(x + y)};
+    }
+    A[j + j * N] = cmpl{1e-3 * static_cast<real>(j), -0.01};
+  }
+  return A;
+}
+} // namespace
+
+TEST_CASE("Fixed-size Bunch-Kaufman LDL^T") {
+  constexpr size_t N = 12;
+  const auto A = test_matrix<N>();
+  auto b = std::array<cmpl, N>{};
+  for (size_t i = 0; i < N; ++i)
+    b[i] = cmpl{1. / static_cast<real>(i + 1), static_cast<real>(i % 3)};
+
+  const auto ldlt = FixedSymmetricLDLT<N>(A);
+  const auto x = ldlt.solve(b);
+
+  for (size_t i = 0; i < N; ++i) {
+    cmpl Ax = 0;
+    for (size_t j = 0; j < N; ++j)
+      Ax += A[i + j * N] * x[j];
+    REQUIRE(Ax.real() == Approx(b[i].real()).margin(1e-10));
+    REQUIRE(Ax.imag() == Approx(b[i].imag()).margin(1e-10));
+  }
+
+  SECTION("multiple right-hand sides") {
+    auto B = std::array<cmpl, N * 2>{};
+    for (size_t i = 0; i < N; ++i) {
+      B[i] = b[i];
+      B[i + N] = 2. * b[i];
+    }
+    const auto X = ldlt.solve<2>(B);
+    for (size_t i = 0; i < N; ++i) {
+      REQUIRE(X[i].real() == Approx(x[i].real()));
+      REQUIRE(X[i + N].imag() == Approx(2. * x[i].imag()));
+    }
+  }
+}
+
+TEST_CASE("Fixed-size LU of a non-symmetric matrix") {
+  constexpr size_t N = 12;
+  auto A = test_matrix<N>();
+  for (size_t j = 0; j < N; ++j)
+    for (size_t i = 0; i < j; ++i)
+      A[i + j * N] += cmpl{0.3 * static_cast<real>(j - i), 0.05};
+  auto b = std::array<cmpl, N>{};
+  for (size_t i = 0; i < N; ++i)
+    b[i] = cmpl{1. / static_cast<real>(i + 1), static_cast<real>(i % 3)};
+
+  const auto x = FixedLU<N>(A).solve(b);
+  for (size_t i = 0; i < N; ++i) {
+    cmpl Ax = 0;
+    for (size_t j = 0; j < N; ++j)
+      Ax += A[i + j * N] * x[j];
+    REQUIRE(Ax.real() == Approx(b[i].real()).margin(1e-10));
+    REQUIRE(Ax.imag() == Approx(b[i].imag()).margin(1e-10));
+  }
+  REQUIRE_THROWS_AS(FixedLU<N>(std::array<cmpl, N * N>{}),
+                    std::runtime_error);
+}
+
+TEST_CASE("LAPACK LDL^T agrees with LU") {
+  constexpr size_t N = 30;
+  const auto a = test_matrix<N>();
+  auto A = xt::xtensor<cmpl, 2>({N, N});
+  auto b = xt::xtensor<cmpl, 1>(std::array<size_t, 1>{N});
+  for (size_t i = 0; i < N; ++i) {
+    for (size_t j = 0; j < N; ++j)
+      A(i, j) = a[i + j * N];
+    b(i) = cmpl{static_cast<real>(i), 1.};
+  }
+
+  const xt::xtensor<cmpl, 1> x_lu = xt::linalg::solve(A, b);
+  const auto x = SymmetricLDLT(A).solve(b);
+  for (size_t i = 0; i < N; ++i) {
+    REQUIRE(x(i).real() == Approx(x_lu(i).real()));
+    REQUIRE(x(i).imag() == Approx(x_lu(i).imag()));
+  }
+
+  // a reused instance, refactored at another size and back
+  auto ldlt = SymmetricLDLT();
+  constexpr size_t M = 7;
+  auto A_small = xt::xtensor<cmpl, 2>({M, M});
+  auto b_small = xt::xtensor<cmpl, 1>(std::array<size_t, 1>{M});
+  for (size_t i = 0; i < M; ++i) {
+    for (size_t j = 0; j < M; ++j)
+      A_small(i, j) = A(i, j);
+    b_small(i) = b(i);
+  }
+  const xt::xtensor<cmpl, 1> x_small = xt::linalg::solve(A_small, b_small);
+  for (const auto &[matrix, rhs, expected] :
+       {std::tuple{A, b, x_lu}, std::tuple{A_small, b_small, x_small},
+        std::tuple{A, b, x_lu}}) {
+    ldlt.factor(matrix);
+    REQUIRE(static_cast<size_t>(ldlt.size()) == matrix.shape()[0]);
+    const auto y = ldlt.solve(rhs);
+    for (size_t i = 0; i < y.size(); ++i) {
+      REQUIRE(y(i).real() == Approx(expected(i).real()));
+      REQUIRE(y(i).imag() == Approx(expected(i).imag()));
+    }
+  }
+}
@@ -1,8 +1,11 @@
 #include "extern/legendre_rule.hpp"
+#include "solver/lagrange_mesh_solver.hpp"
 
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <cmath>
+
 using Catch::Approx;
 
 TEST_CASE("GL weights shift reduce") {
@@ -19,3 +22,73 @@ TEST_CASE("GL weights shift reduce") {
     REQUIRE(quadrature[8].abscissa == Approx(0.93253168));
   }
 }
+
+TEST_CASE("Compile-time GL rule matches runtime rule") {
+  static_assert(gl::FixedRule<10>::nodes[0].abscissa > 0.013 and
+                gl::FixedRule<10>::nodes[0].abscissa < 0.0131);
+
+  const auto quadrature = gl::generate_gauss_legendre_quadrature(30);
+  const auto &nodes = gl::FixedRule<30>::nodes;
+  for (size_t i = 0; i < 30; ++i) {
+    REQUIRE(nodes[i].abscissa == Approx(quadrature[i].abscissa).epsilon(1e-12));
+    REQUIRE(nodes[i].weight == Approx(quadrature[i].weight).epsilon(1e-12));
+  }
+}
+
+TEST_CASE("Newton GL generator") {
+  SECTION("matches Golub-Welsch") {
+    for (const int n : {1, 2, 7, 40, 99, 150, 400}) {
+      const auto newton = gl::generate_gauss_legendre_quadrature(n);
+      const auto reference = gl::golub_welsch_quadrature(n);
+      // Golub-Welsch only has absolute precision in abscissas near 0
+      for (int i = 0; i < n; ++i) {
+        REQUIRE(newton[i].abscissa ==
+                Approx(reference[i].abscissa).epsilon(1e-12).margin(1e-15));
+        REQUIRE(newton[i].weight == Approx(reference[i].weight).epsilon(1e-10));
+      }
+    }
+  }
+
+  SECTION("large order integrates polynomials exactly") {
+    const int n = 1000;
+    const auto quadrature = gl::generate_gauss_legendre_quadrature(n);
+    double sum = 0;
+    double x5 = 0;
+    for (const auto &node : quadrature) {
+      sum += node.weight;
+      x5 += node.weight * pow(node.abscissa, 5);
+    }
+    REQUIRE(sum == Approx(1.).epsilon(1e-13));
+    REQUIRE(x5 == Approx(1. / 6.).epsilon(1e-13));
+    for (int i = 1; i < n; ++i)
+      REQUIRE(quadrature[i].abscissa > quadrature[i - 1].abscissa);
+  }
+
+  SECTION("cache") {
+    const auto &a = gl::gauss_legendre_quadrature(25);
+    const auto &b = gl::gauss_legendre_quadrature(25);
+    REQUIRE(&a == &b);
+    REQUIRE(a.size() == 25);
+  }
+}
+
+#ifdef OSIRIS_GL_TABLES
+TEST_CASE("Build-time GL tables") {
+  static_assert(gl::FixedRule<20>::nodes.size() == 20);
+  static_assert(gl::FixedRule<20>::nodes[0].weight ==
+                gl::FixedRule<20>::nodes[19].weight);
+
+  for (const int n : {10, 15, 20, 25, 30, 40, 50, 60}) {
+    const auto *nodes = gl::tabulated_rule(n);
+    REQUIRE(nodes != nullptr);
+    const auto runtime = gl::generate_gauss_legendre_quadrature(n);
+    const auto &cached = gl::gauss_legendre_quadrature(n);
+    for (int i = 0; i < n; ++i) {
+      REQUIRE(nodes[i].abscissa == runtime[i].abscissa);
+      REQUIRE(nodes[i].weight == runtime[i].weight);
+      REQUIRE(cached[i].abscissa == runtime[i].abscissa);
+    }
+  }
+  REQUIRE(gl::tabulated_rule(17) == nullptr);
+}
+#endif
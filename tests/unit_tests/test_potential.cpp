@@ -1,10 +1,22 @@
 
+#include "potential/composite.hpp"
+#include "potential/ensemble.hpp"
 #include "potential/params.hpp"
 #include "potential/potential.hpp"
+#include "potential/sample_store.hpp"
+#include "potential/sample_stream.hpp"
 
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
 using Catch::Approx;
 
 using namespace osiris;
@@ -36,3 +48,419 @@ TEST_CASE("test WLH neutron potential") {
   auto omp_params = get_global_terms(Xe144, erg_cms, wlh_params);
   auto V = OMP<xt::xarray<real>>(1. / 2.);
 }
+
+TEST_CASE("batch evaluation matches pointwise evaluation") {
+  using Params = xt::xtensor<real, 1>;
+  const auto r = std::vector<real>{0.1, 0.8, 2.5, 5.3, 7.9, 12.};
+  const auto n = r.size();
+  auto out = std::vector<cmpl>(n);
+
+  const auto check = [&](const Potential<Params> &v, const Params &params) {
+    v.batch(r.data(), n, params, out.data());
+    for (size_t i = 0; i < n; ++i) {
+      REQUIRE(out[i].real() == Approx(v(r[i], params).real()));
+      REQUIRE(out[i].imag() == Approx(v(r[i], params).imag()));
+    }
+  };
+
+  check(WoodsSaxon<Params>{}, {-45., 5.8, 0.65});
+  check(WoodsSaxon<Params>{}, {-45., 5.8, 0.});
+  check(DerivWoodsSaxon<Params>{}, {8., 6.1, 0.55});
+  check(Thomas<Params>{}, {5.5, 5.6, 0.6});
+  check(Gaussian<Params>{}, {1., 0., 3.});
+  check(Gaussian<Params>{}, {-71., 1.2, 0.85});
+
+  // V exp(-(r - R)^2 / sigma^2), decaying away from R
+  const auto gaussian = Gaussian<Params>{};
+  const auto gaussian_params = Params{-71., 1.2, 0.85};
+  gaussian.batch(r.data(), n, gaussian_params, out.data());
+  for (size_t i = 0; i < n; ++i) {
+    const auto x = (r[i] - 1.2) / 0.85;
+    REQUIRE(out[i].real() == Approx(-71. * std::exp(-x * x)));
+    REQUIRE(out[i].imag() == 0.);
+  }
+  REQUIRE(gaussian(1.2, gaussian_params).real() == Approx(-71.));
+  REQUIRE(std::abs(gaussian(12., gaussian_params)) < 1e-50);
+  check(Yukawa<Params>{}, {1.4, 10.});
+
+  const Params omp_params =
+      get_global_terms(Xe144, erg_cms, KD03Params<Proj::neutron>());
+  check(OMP<Params>(1. / 2.), omp_params);
+  check(OMP<Params>(-1.), omp_params);
+
+  // terms sharing a geometry are evaluated from one exponential
+  for (const Params &p :
+       {Params(get_global_terms(Xe144, erg_cms, CH89Params<Proj::neutron>())),
+        Params(
+            get_global_terms(Xe144, erg_cms, WLH21Params<Proj::neutron>()))}) {
+    check(OMP<Params>(1. / 2.), p);
+    auto shared = p;
+    shared(4) = shared(1);
+    shared(5) = shared(2);
+    shared(17) = 0;
+    check(OMP<Params>(1. / 2.), shared);
+  }
+}
+
+TEST_CASE("typed OMP terms") {
+  using Params = xt::xtensor<real, 1>;
+  const auto kd_params = KD03Params<Proj::neutron>();
+  const Params params = get_global_terms(Xe144, erg_cms, kd_params);
+  const auto terms = get_omp_terms(Xe144, erg_cms, kd_params);
+
+  const auto array = terms.to_array();
+  const auto round_trip = to_omp_terms(params).to_array();
+  for (size_t k = 0; k < 18; ++k) {
+    REQUIRE(array(k) == params(k));
+    REQUIRE(round_trip(k) == params(k));
+  }
+  REQUIRE(terms.cmpl_cent.R == terms.real_cent.R);
+
+  const auto V = OMP<Params>(1. / 2.);
+  REQUIRE(V(0.8, terms).real() == Approx(-43.363118795927214));
+  REQUIRE(V(0.8, terms).imag() == Approx(-0.8760279215437633));
+
+  const auto r = std::vector<real>{0.5, 3., 6.5, 11.};
+  auto out = std::vector<cmpl>(r.size());
+  V.batch(r.data(), r.size(), terms, out.data());
+  for (size_t i = 0; i < r.size(); ++i) {
+    REQUIRE(out[i].real() == Approx(V(r[i], params).real()));
+    REQUIRE(out[i].imag() == Approx(V(r[i], params).imag()));
+  }
+}
+
+TEST_CASE("composite potentials") {
+  using Params = xt::xtensor<real, 1>;
+  using constants::i;
+  const Params params =
+      get_global_terms(Xe144, erg_cms, KD03Params<Proj::neutron>());
+  const auto r = std::vector<real>{0.3, 1.7, 4.2, 6.6, 9.5};
+  auto out = std::vector<cmpl>(r.size());
+
+  SECTION("reproduces OMP") {
+    for (const real ls : {0.5, -1.}) {
+      const auto v = compose<Params>(
+          terms::WoodsSaxon<0>{} + i * terms::WoodsSaxon<3>{} +
+          terms::DerivWoodsSaxon<6>{} + i * terms::DerivWoodsSaxon<9>{} +
+          ls * (terms::Thomas<12>{} + i * terms::Thomas<15>{}));
+      static_assert(decltype(v)::arity == 18);
+      const auto omp = OMP<Params>(ls);
+      v.batch(r.data(), r.size(), params, out.data());
+      for (size_t k = 0; k < r.size(); ++k) {
+        REQUIRE(out[k].real() == Approx(omp(r[k], params).real()));
+        REQUIRE(out[k].imag() == Approx(omp(r[k], params).imag()));
+        REQUIRE(v(r[k], params).real() == Approx(out[k].real()));
+        REQUIRE(v(r[k], params).imag() == Approx(out[k].imag()));
+      }
+    }
+  }
+
+  SECTION("uniform sphere Coulomb") {
+    const auto q2 = 54 * constants::e_sqr;
+    const auto Rc = 6.5;
+    const auto v = compose<Params>(terms::Coulomb<0>{});
+    const Params p = {q2, Rc};
+    REQUIRE(v(0., p).real() == Approx(1.5 * q2 / Rc));
+    REQUIRE(v(Rc, p).real() == Approx(q2 / Rc));
+    REQUIRE(v(Rc - 1e-9, p).real() == Approx(q2 / Rc));
+    REQUIRE(v(20., p).real() == Approx(q2 / 20.));
+    REQUIRE(v(20., p).imag() == 0.);
+  }
+}
+
+TEST_CASE("proton OMP with uniform-sphere Coulomb") {
+  using Params = xt::xtensor<real, 1>;
+  const auto kd_params = KD03Params<Proj::proton>();
+  const Params params = get_global_proton_terms(Xe144, erg_cms, kd_params);
+  REQUIRE(params.size() == 20);
+  REQUIRE(params(18) == Approx(Xe144.Z * e_sqr));
+  REQUIRE(params(19) == Approx(kd_params.real_coul_r(Xe144.Z, Xe144.A, 0) *
+                               pow(Xe144.A, 1. / 3.)));
+
+  const auto V = ProtonOMP<Params>(1. / 2.);
+  // inside, at, and outside the charged sphere; ascending and not
+  for (const auto &r : {std::vector<real>{0.2, 1.5, 3.7, params(19), 6.8, 9.},
+                        std::vector<real>{9., 0.2, 6.8, 1.5}}) {
+    auto out = std::vector<cmpl>(r.size());
+    V.batch(r.data(), r.size(), params, out.data());
+    for (size_t i = 0; i < r.size(); ++i) {
+      REQUIRE(out[i].real() == Approx(V(r[i], params).real()));
+      REQUIRE(out[i].imag() == Approx(V(r[i], params).imag()));
+    }
+  }
+
+  const auto Rc = params(19);
+  REQUIRE(ProtonOMP<Params>::coulomb(0., params) ==
+          Approx(1.5 * params(18) / Rc));
+  REQUIRE(ProtonOMP<Params>::coulomb(2 * Rc, params) ==
+          Approx(params(18) / (2 * Rc)));
+}
+
+TEST_CASE("isotope-bound global parameters") {
+  const auto check = [](const auto &p) {
+    const auto b = p.bind(Xe144.Z, Xe144.A);
+    for (const auto erg : {0.5, 14., 25., 45., 150.}) {
+      const auto expected = get_omp_terms(Xe144, erg, p).to_array();
+      const auto terms = get_omp_terms(b, erg).to_array();
+      REQUIRE(terms.size() == expected.size());
+      for (size_t k = 0; k < terms.size(); ++k)
+        REQUIRE(terms(k) == Approx(expected(k)).epsilon(1e-12));
+
+      const auto global = get_global_terms(b, erg);
+      REQUIRE(global.size() == 18);
+      for (size_t k = 0; k < 18; ++k)
+        REQUIRE(global(k) == terms(k));
+    }
+  };
+
+  check(KD03Params<Proj::neutron>());
+  check(KD03Params<Proj::proton>());
+  check(KD03Params<Proj::proton>::build_KDUQ());
+  check(CH89Params<Proj::neutron>());
+  check(CH89Params<Proj::proton>());
+  check(WLH21Params<Proj::neutron>());
+  check(WLH21Params<Proj::proton>());
+}
+
+TEST_CASE("global parameters over isotope and energy grids") {
+  const auto isotopes = std::vector<Isotope>{
+      {48, 20, 47.95252}, {90, 40, 89.90470}, Xe144, {208, 82, 207.97665}};
+  const auto ergs = std::vector<real>{0.1, 1., 14., 30., 60., 200.};
+
+  const auto check = [&](const auto &p) {
+    const auto grid = get_global_terms(isotopes, ergs, p);
+    REQUIRE(grid.shape()[0] == 18);
+    REQUIRE(grid.shape()[1] == isotopes.size() * ergs.size());
+    for (size_t i = 0; i < isotopes.size(); ++i) {
+      for (size_t j = 0; j < ergs.size(); ++j) {
+        const auto expected = get_global_terms(isotopes[i], ergs[j], p);
+        for (size_t k = 0; k < 18; ++k)
+          REQUIRE(grid(k, i * ergs.size() + j) ==
+                  Approx(expected(k)).epsilon(1e-12));
+      }
+    }
+  };
+
+  check(KD03Params<Proj::neutron>());
+  check(KD03Params<Proj::proton>());
+  check(CH89Params<Proj::proton>());
+  check(WLH21Params<Proj::neutron>());
+}
+
+TEST_CASE("UQ parameter ensembles") {
+  const auto check = [](const auto &ensemble, const auto &samples) {
+    REQUIRE(ensemble.size() == samples.size());
+    for (const auto erg : {0.5, 14., 60.}) {
+      const auto terms = ensemble.terms(Xe144, erg);
+      REQUIRE(terms.shape()[0] == 18);
+      REQUIRE(terms.shape()[1] == samples.size());
+      for (size_t s = 0; s < samples.size(); ++s) {
+        const auto expected = get_global_terms(Xe144, erg, samples[s]);
+        for (size_t k = 0; k < 18; ++k)
+          REQUIRE(terms(k, s) == Approx(expected(k)).epsilon(1e-12));
+      }
+    }
+  };
+
+  const auto kdn = std::vector<KD03Params<Proj::neutron>>{
+      KD03Params<Proj::neutron>(), KD03Params<Proj::neutron>::build_KDUQ()};
+  check(KD03Ensemble(kdn), kdn);
+  const auto kdp = std::vector<KD03Params<Proj::proton>>{
+      KD03Params<Proj::proton>(), KD03Params<Proj::proton>::build_KDUQ()};
+  check(KD03Ensemble(kdp), kdp);
+
+  const auto chn = std::vector<CH89Params<Proj::neutron>>{
+      CH89Params<Proj::neutron>(), CH89Params<Proj::neutron>::build_CHUQ()};
+  check(CH89Ensemble(chn), chn);
+  const auto chp = std::vector<CH89Params<Proj::proton>>{
+      CH89Params<Proj::proton>(), CH89Params<Proj::proton>()};
+  check(CH89Ensemble(chp), chp);
+}
+
+TEST_CASE("binary parameter sample store") {
+  auto in = std::ifstream("KD_default.json");
+  const json kd_default = json::parse(in);
+
+  // perturbed copies of the default parameters
+  auto samples = std::vector<json>{};
+  for (int s = 0; s < 5; ++s) {
+    auto sample = kd_default;
+    sample["KDHartreeFock"]["V1_0"] = 59.3 + 0.25 * s;
+    sample["KDImagSurface"]["D3_0"] = 11.5 - 0.5 * s;
+    samples.push_back(sample);
+  }
+  SampleStore::write("kd_samples.bin", samples);
+
+  const auto store = SampleStore("kd_samples.bin");
+  REQUIRE(store.size() == samples.size());
+  REQUIRE(store.column("/KDHartreeFock/V1_0")[3] == 59.3 + 0.25 * 3);
+  REQUIRE(store.to_json(2) == samples[2]);
+  REQUIRE_THROWS_AS(store.index("/KDHartreeFock/nope"), std::runtime_error);
+
+  auto kdn = std::vector<KD03Params<Proj::neutron>>{};
+  auto kdp = std::vector<KD03Params<Proj::proton>>{};
+  for (size_t s = 0; s < store.size(); ++s) {
+    const auto expected = KD03Params<Proj::neutron>(samples[s]);
+    kdn.push_back(store.sample<KD03Params<Proj::neutron>>(s));
+    kdp.push_back(store.sample<KD03Params<Proj::proton>>(s));
+    REQUIRE(kdn.back().real_cent_V(Xe144.Z, Xe144.A, erg_cms) ==
+            expected.real_cent_V(Xe144.Z, Xe144.A, erg_cms));
+    REQUIRE(kdn.back().cmpl_surf_V(Xe144.Z, Xe144.A, erg_cms) ==
+            expected.cmpl_surf_V(Xe144.Z, Xe144.A, erg_cms));
+  }
+
+  const auto ensemble = KD03Ensemble(store).terms(Xe144, erg_cms);
+  for (const auto &expected : {KD03Ensemble(kdn).terms(Xe144, erg_cms),
+                               KD03Ensemble(kdp).terms(Xe144, erg_cms)}) {
+    for (size_t k = 0; k < 18; ++k)
+      for (size_t s = 0; s < store.size(); ++s)
+        REQUIRE(ensemble(k, s) == expected(k, s));
+  }
+
+  // a stored Fermi energy is read rather than replaced by the default
+  auto fermi_samples = samples;
+  for (size_t s = 0; s < fermi_samples.size(); ++s)
+    fermi_samples[s]["KDFermi"] = {{"E_f_0", -11.0 - 0.1 * s},
+                                   {"E_f_A", 0.025}};
+  SampleStore::write("kd_fermi_samples.bin", fermi_samples);
+  const auto fermi_store = SampleStore("kd_fermi_samples.bin");
+  auto fermi_params = std::vector<KD03Params<Proj::neutron>>{};
+  for (const auto &sample : fermi_samples)
+    fermi_params.emplace_back(sample);
+  const auto fermi = KD03Ensemble(fermi_store).terms(Xe144, erg_cms);
+  const auto fermi_expected = KD03Ensemble(fermi_params).terms(Xe144, erg_cms);
+  for (size_t k = 0; k < 18; ++k)
+    for (size_t s = 0; s < fermi_store.size(); ++s)
+      REQUIRE(fermi(k, s) == fermi_expected(k, s));
+  REQUIRE(fermi(0, 1) != ensemble(0, 1));
+
+  SampleStore::convert("CH89_default.json", "ch_samples.bin");
+  const auto ch_store = SampleStore("ch_samples.bin");
+  REQUIRE(ch_store.size() == 1);
+  const auto ch = CH89Ensemble(ch_store).terms(Xe144, erg_cms);
+  const auto ch_expected = get_global_terms(
+      Xe144, erg_cms, ch_store.sample<CH89Params<Proj::neutron>>(0));
+  for (size_t k = 0; k < 18; ++k)
+    REQUIRE(ch(k, 0) == Approx(ch_expected(k)).epsilon(1e-12));
+
+  REQUIRE_THROWS_AS(SampleStore("CH89_default.json"), std::runtime_error);
+
+  // parameters read straight from the columns equal those read from JSON
+  const auto chp = ch_store.sample<CH89Params<Proj::proton>>(0);
+  const auto chp_json = CH89Params<Proj::proton>(ch_store.to_json(0));
+  const auto chp_terms = get_global_terms(Xe144, erg_cms, chp);
+  const auto chp_json_terms = get_global_terms(Xe144, erg_cms, chp_json);
+  for (size_t k = 0; k < 18; ++k)
+    REQUIRE(chp_terms(k) == chp_json_terms(k));
+  REQUIRE(chp.real_coul_r(Xe144.Z, Xe144.A, erg_cms) ==
+          chp_json.real_coul_r(Xe144.Z, Xe144.A, erg_cms));
+  const auto kdp_fermi = fermi_store.sample<KD03Params<Proj::proton>>(2);
+  const auto kdp_json = KD03Params<Proj::proton>(fermi_samples[2]);
+  const auto kdp_terms = get_global_terms(Xe144, erg_cms, kdp_fermi);
+  const auto kdp_json_terms = get_global_terms(Xe144, erg_cms, kdp_json);
+  for (size_t k = 0; k < 18; ++k)
+    REQUIRE(kdp_terms(k) == kdp_json_terms(k));
+  REQUIRE(kdp_fermi.real_coul_r(Xe144.Z, Xe144.A, erg_cms) ==
+          kdp_json.real_coul_r(Xe144.Z, Xe144.A, erg_cms));
+  REQUIRE(store.row(0).contains("KDHartreeFock"));
+  REQUIRE(not store.row(0).contains("KDFermi"));
+  REQUIRE_THROWS_AS(store.row(0)["KDHartreeFock"]["nope"], std::runtime_error);
+
+  // trailing garbage, and a sample count whose byte size overflows
+  auto bytes = std::string{};
+  {
+    auto file = std::ifstream("ch_samples.bin", std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(file), {});
+  }
+  const auto write_bytes = [](const std::string &contents) {
+    auto out = std::ofstream("corrupt.bin", std::ios::binary);
+    out << contents;
+  };
+  write_bytes(bytes + "abc");
+  REQUIRE_THROWS_AS(SampleStore("corrupt.bin"), std::runtime_error);
+  auto overflow = bytes;
+  const uint64_t huge = (uint64_t{1} << 61) + 1;
+  std::memcpy(overflow.data() + 24, &huge, sizeof(huge));
+  write_bytes(overflow);
+  REQUIRE_THROWS_AS(SampleStore("corrupt.bin"), std::runtime_error);
+  write_bytes(bytes);
+  REQUIRE(SampleStore("corrupt.bin").size() == 1);
+}
+
+TEST_CASE("streaming parameter samples") {
+  auto in = std::ifstream("KD_default.json");
+  const json kd_default = json::parse(in);
+
+  auto samples = std::vector<json>{};
+  for (int s = 0; s < 7; ++s) {
+    auto sample = kd_default;
+    sample["KDHartreeFock"]["V1_0"] = 59.3 + 0.25 * s;
+    samples.push_back(sample);
+  }
+  auto array = std::stringstream(json(samples).dump(2));
+  auto lines = std::stringstream{};
+  for (const auto &sample : samples)
+    lines << sample.dump() << "\n\n";
+
+  using Params = KD03Params<Proj::neutron>;
+  const auto expected = [&](size_t s) {
+    return Params(samples[s]).real_cent_V(Xe144.Z, Xe144.A, erg_cms);
+  };
+
+  for (auto [stream, format] :
+       {std::pair{&array, SampleFormat::json},
+        std::pair{&lines, SampleFormat::json_lines}}) {
+    auto read = std::vector<json>{};
+    REQUIRE(stream_samples(*stream, format, [&](json &&sample) {
+              read.push_back(std::move(sample));
+            }) == samples.size());
+    REQUIRE(read == samples);
+
+    stream->clear();
+    stream->seekg(0);
+    auto sizes = std::vector<size_t>{};
+    size_t s = 0;
+    stream_blocks<Params>(*stream, format, 3, [&](std::vector<Params> &&b) {
+      sizes.push_back(b.size());
+      const auto terms = KD03Ensemble(b).terms(Xe144, erg_cms);
+      for (size_t i = 0; i < b.size(); ++i, ++s)
+        REQUIRE(terms(0, i) == expected(s));
+    });
+    REQUIRE(sizes == std::vector<size_t>{3, 3, 1});
+
+    stream->clear();
+    stream->seekg(0);
+    auto values = std::vector<real>(samples.size());
+    REQUIRE(stream_params_parallel<Params>(
+                *stream, format, 3, 2, [&](size_t s, Params &&params) {
+                  values[s] =
+                      params.real_cent_V(Xe144.Z, Xe144.A, erg_cms);
+                }) == samples.size());
+    for (size_t s = 0; s < samples.size(); ++s)
+      REQUIRE(values[s] == expected(s));
+
+    stream->clear();
+    stream->seekg(0);
+    auto calls = std::atomic<size_t>{0};
+    REQUIRE_THROWS_AS(stream_params_parallel<Params>(
+                          *stream, format, 2, 1,
+                          [&](size_t, Params &&) {
+                            ++calls;
+                            throw std::runtime_error("worker failed");
+                          }),
+                      std::runtime_error);
+    REQUIRE(calls > 0);
+  }
+
+  auto single = std::stringstream(kd_default.dump());
+  REQUIRE(stream_params<Params>(single, SampleFormat::json,
+                                [](Params &&) {}) == 1);
+  auto truncated = std::stringstream(json(samples).dump().substr(0, 100));
+  REQUIRE_THROWS_AS(stream_samples(truncated, SampleFormat::json,
+                                   [](json &&) {}),
+                    std::runtime_error);
+  auto numbers = std::stringstream("[1, 2, 3]");
+  REQUIRE_THROWS_AS(stream_samples(numbers, SampleFormat::json,
+                                   [](json &&) {}),
+                    std::runtime_error);
+}
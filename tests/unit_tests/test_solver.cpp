@@ -0,0 +1,619 @@
+#include "potential/potential.hpp"
+#include "solver/lagrange_mesh_solver.hpp"
+#include "solver/solver.hpp"
+#include "util/asymptotics.hpp"
+#include "util/constants.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <memory>
+
+using namespace osiris;
+
+using Catch::Approx;
+
+using Params = xt::xtensor<real, 1>;
+
+namespace {
+/// @brief Gaussian-smeared volume well, V0 exp(-(r - r')^2/b^2) / (1 +
+/// exp((r + r')/2 - R)/a)), relying on the default tile evaluation
+struct SmearedWell : public NonlocalPotential<Params> {
+  cmpl operator()(real r, real rp, Params params) const final {
+    const auto rm = 0.5 * (r + rp);
+    const auto d = (r - rp) / params(3);
+    return cmpl{params(0), params(4)} * exp(-d * d) /
+           (1. + exp((rm - params(1)) / params(2)));
+  }
+};
+
+/// @brief Woods-Saxon that counts pointwise evaluations, to check that
+/// solvers evaluate local potentials on the whole mesh at once
+struct CountingWoodsSaxon : public Potential<Params> {
+  mutable int pointwise = 0;
+  cmpl operator()(real r, Params params) const final {
+    ++pointwise;
+    return WoodsSaxon<Params>{}(r, params);
+  }
+  void batch(const real *r, size_t n, const Params &params,
+             cmpl *out) const final {
+    WoodsSaxon<Params>{}.batch(r, n, params, out);
+  }
+};
+} // namespace
+
+TEST_CASE("Free R-matrix matches Riccati-Bessel functions") {
+  const auto ch = Channel(0., 12., constants::n_mass_amu, 0, 2, 40., 20);
+  const auto solver = RMatrixKernel(40, 1);
+  const auto e = ch.set_erg_cms(10.);
+  const auto s = e.k * ch.radius;
+
+  for (int l = 0; l < 4; ++l) {
+    const auto am = Channel::FermionSpinOrbitCoupling(2 * l + 2, l);
+    const auto m =
+        solver.matrices(ch, e, am, WoodsSaxon<Params>{}, Params{0., 4.1, 0.6});
+    const auto F = asymptotics::F{l}(s);
+    const auto dF = asymptotics::d_dz(asymptotics::F{l})(s).real();
+
+    REQUIRE(m.R.real() == Approx(F / (s * dF)));
+    REQUIRE(m.R.imag() == Approx(0.).margin(1e-12));
+    REQUIRE(m.S.real() == Approx(1.));
+    REQUIRE(m.S.imag() == Approx(0.).margin(1e-8));
+  }
+}
+
+TEST_CASE("Woods-Saxon R-matrix matches direct integration") {
+  // n + 40Ca at 10 MeV, reference R-matrix from RK4 integration of the
+  // radial Schrödinger equation out to the channel radius
+  const auto ch = Channel(0., 12., constants::n_mass_amu, 0, 2, 40., 20);
+  const auto solver = RMatrixKernel(40, 1);
+  const auto e = ch.set_erg_cms(10.);
+  const auto params = Params{-50., 4.1, 0.6};
+
+  const auto R = [&](int l) {
+    const auto am = Channel::FermionSpinOrbitCoupling(2 * l + 2, l);
+    return solver.rmatrix(ch, e, am, WoodsSaxon<Params>{}, params);
+  };
+
+  REQUIRE(R(0).real() == Approx(-0.002967959330).margin(1e-8));
+  REQUIRE(R(1).real() == Approx(9.993887146815).epsilon(1e-6));
+  REQUIRE(R(2).real() == Approx(-0.034004879227).epsilon(1e-6));
+  REQUIRE(R(3).real() == Approx(0.191987058734).epsilon(1e-6));
+}
+
+TEST_CASE("Absorptive potential removes flux") {
+  const auto ch = Channel(0., 12., constants::n_mass_amu, 0, 2, 40., 20);
+  const auto solver = RMatrixKernel(40, 1);
+  const auto e = ch.set_erg_cms(10.);
+  const auto am = Channel::FermionSpinOrbitCoupling();
+
+  const auto real_ws = solver.matrices(ch, e, am, WoodsSaxon<Params>{},
+                                       Params{-50., 4.1, 0.6});
+  const auto v = OMP<Params>(am.l_dot_s());
+  auto params = Params(std::array<size_t, 1>{18});
+  params.fill(0.);
+  params(0) = -50.;
+  params(1) = 4.1;
+  params(2) = 0.6;
+  params(3) = -10.;
+  params(4) = 4.1;
+  params(5) = 0.6;
+  const auto cmpl_ws = solver.matrices(ch, e, am, v, params);
+
+  REQUIRE(std::abs(real_ws.S) == Approx(1.));
+  REQUIRE(std::abs(cmpl_ws.S) < 1.);
+  REQUIRE(cmpl_ws.phase_shift.imag() > 0.);
+}
+
+TEST_CASE("Pole expansion reproduces direct solve") {
+  const auto ch = Channel(0., 12., constants::n_mass_amu, 0, 2, 40., 20);
+  const auto solver = RMatrixKernel(40, 1);
+  const auto am = Channel::FermionSpinOrbitCoupling(4, 1);
+  const auto v = OMP<Params>(am.l_dot_s());
+  auto params = Params(std::array<size_t, 1>{18});
+  params.fill(0.);
+  params(0) = -50.;
+  params(1) = 4.1;
+  params(2) = 0.6;
+
+  SECTION("real potential") {
+    const auto e = ch.set_erg_cms(5.);
+    const auto poles = solver.poles(ch, e, am, v, params);
+    const auto R = solver.rmatrix(ch, e, am, v, params);
+    REQUIRE(poles.at_wavenumber(e.k).real() == Approx(R.real()));
+    REQUIRE(poles.at_wavenumber(e.k).imag() == Approx(0.).margin(1e-10));
+  }
+
+  SECTION("absorptive potential") {
+    params(3) = -10.;
+    params(4) = 4.1;
+    params(5) = 0.6;
+    const auto e = ch.set_erg_cms(5.);
+    const auto poles = solver.poles(ch, e, am, v, params);
+    const auto R = solver.rmatrix(ch, e, am, v, params);
+    REQUIRE(poles.at_wavenumber(e.k).real() == Approx(R.real()));
+    REQUIRE(poles.at_wavenumber(e.k).imag() == Approx(R.imag()));
+  }
+
+  SECTION("energy sweep") {
+    const auto ergs = std::vector<real>{1.0, 1.01, 1.02, 1.03};
+    const auto sweep = solver.matrices(ch, ergs, am, v, params);
+    REQUIRE(sweep.size() == ergs.size());
+    const auto direct = solver.matrices(ch, ch.set_erg_cms(ergs[0]), am, v,
+                                        params);
+    REQUIRE(sweep[0].S.real() == Approx(direct.S.real()));
+    REQUIRE(sweep[0].S.imag() == Approx(direct.S.imag()));
+    // away from the first energy the only difference is the drift of the
+    // relativistic reduced mass, which the sweep follows to within mu_rtol
+    for (size_t i = 1; i < ergs.size(); ++i) {
+      const auto d = solver.matrices(ch, ch.set_erg_cms(ergs[i]), am, v, params);
+      REQUIRE(sweep[i].phase_shift.real() ==
+              Approx(d.phase_shift.real()).epsilon(1e-3));
+    }
+  }
+
+  SECTION("wide energy sweep tracks the reduced mass") {
+    auto ergs = std::vector<real>{};
+    for (real erg = 0.1; erg <= 200.; erg *= 1.05)
+      ergs.push_back(erg);
+    const auto check = [&](const std::vector<ScatteringMatrices> &sweep,
+                           real R_tol, real S_tol) {
+      for (size_t i = 0; i < ergs.size(); ++i) {
+        const auto d =
+            solver.matrices(ch, ch.set_erg_cms(ergs[i]), am, v, params);
+        REQUIRE(abs(sweep[i].R - d.R) <= R_tol * abs(d.R));
+        REQUIRE(abs(sweep[i].S - d.S) <= S_tol);
+      }
+    };
+    check(solver.matrices(ch, ergs, am, v, params, 0.), 1e-8, 1e-8);
+    // the first order reduced-mass correction leaves errors of order
+    // mu_rtol^2
+    check(solver.matrices(ch, ergs, am, v, params, 1e-4), 1e-4, 1e-4);
+    check(solver.matrices(ch, ergs, am, v, params), 1e-2, 1e-4);
+  }
+
+  SECTION("fine sweep rediagonalizes only as the reduced mass drifts") {
+    // the 500 point, 0.01 - 10 MeV grid of the example app, n + 144Xe
+    const auto xe = Channel(0., 12., constants::n_mass_amu, 0, 2, 143.93851,
+                            54);
+    params(1) = 6.3;
+    params(2) = 0.65;
+    params(9) = -5.;
+    params(10) = 6.5;
+    params(11) = 0.5;
+    auto ergs = std::vector<real>{};
+    for (int i = 0; i < 500; ++i)
+      ergs.push_back(0.01 + 9.99 * static_cast<real>(i) / 500.);
+    const auto rebuilds = RMatrixKernel::sweep_rebuilds(xe, ergs, 1e-3);
+    REQUIRE(rebuilds.front() == 0);
+    REQUIRE(rebuilds.size() <= 12);
+    REQUIRE(RMatrixKernel::sweep_rebuilds(xe, ergs, 0.).size() == 500);
+
+    const auto sweep = solver.matrices(xe, ergs, am, v, params);
+    for (size_t i = 0; i < ergs.size(); ++i) {
+      const auto d =
+          solver.matrices(xe, xe.set_erg_cms(ergs[i]), am, v, params);
+      REQUIRE(abs(sweep[i].S - d.S) <= 1e-4);
+    }
+  }
+}
+
+TEST_CASE("All partial waves match single-wave solves") {
+  const auto ch = Channel(0., 12., constants::n_mass_amu, 0, 2, 40., 20);
+  const auto e = ch.set_erg_cms(10.);
+  const auto solver = RMatrixKernel(40, 1);
+  auto params = Params(std::array<size_t, 1>{18});
+  params.fill(0.);
+  params(0) = -50.;
+  params(1) = 4.1;
+  params(2) = 0.6;
+  params(9) = -5.;
+  params(10) = 4.3;
+  params(11) = 0.5;
+  params(12) = 5.5;
+  params(13) = 4.0;
+  params(14) = 0.6;
+
+  const int lmax = 6;
+  const auto waves = solver.partial_waves(ch, e, params, lmax);
+  const auto &up = waves[static_cast<int>(Polarization::up)];
+  const auto &down = waves[static_cast<int>(Polarization::down)];
+  REQUIRE(up.size() == lmax);
+  REQUIRE(down.size() == lmax - 1);
+
+  for (int l = 0; l < lmax; ++l) {
+    const auto am = Channel::FermionSpinOrbitCoupling(2 * l + 2, l);
+    const auto S = solver.matrices(ch, e, am, OMP<Params>(am.l_dot_s()), params).S;
+    REQUIRE(up[l].S.real() == Approx(S.real()));
+    REQUIRE(up[l].S.imag() == Approx(S.imag()));
+  }
+  for (int l = 1; l < lmax; ++l) {
+    const auto am = Channel::FermionSpinOrbitCoupling(2 * l, l);
+    const auto S = solver.matrices(ch, e, am, OMP<Params>(am.l_dot_s()), params).S;
+    REQUIRE(down[l - 1].S.real() == Approx(S.real()));
+    REQUIRE(down[l - 1].S.imag() == Approx(S.imag()));
+  }
+
+  const auto typed = solver.partial_waves(ch, e, to_omp_terms(params), lmax);
+  for (int l = 0; l < lmax; ++l) {
+    const auto S = typed[static_cast<int>(Polarization::up)][l].S;
+    REQUIRE(S.real() == Approx(up[l].S.real()));
+    REQUIRE(S.imag() == Approx(up[l].S.imag()));
+  }
+
+  auto cache = AsymptoticsCache(4);
+  for (int pass = 0; pass < 2; ++pass) {
+    const auto cached = solver.partial_waves(ch, e, params, lmax, &cache);
+    REQUIRE(cache.size() == 1);
+    for (int l = 0; l < lmax; ++l)
+      REQUIRE(cached[static_cast<int>(Polarization::up)][l].S == up[l].S);
+  }
+}
+
+TEST_CASE("Symmetric and LU backends agree") {
+  const auto ch = Channel(0., 12., constants::n_mass_amu, 0, 2, 40., 20);
+  const auto e = ch.set_erg_cms(10.);
+  const auto am = Channel::FermionSpinOrbitCoupling(4, 1);
+  const auto v = OMP<Params>(am.l_dot_s());
+  auto params = Params(std::array<size_t, 1>{18});
+  params.fill(0.);
+  params(0) = -50.;
+  params(1) = 4.1;
+  params(2) = 0.6;
+  params(3) = -10.;
+  params(4) = 4.1;
+  params(5) = 0.6;
+
+  const auto R_lu =
+      RMatrixKernel(40, 1, Factorization::lu).rmatrix(ch, e, am, v, params);
+  const auto R_ldlt = RMatrixKernel(40, 1, Factorization::symmetric)
+                          .rmatrix(ch, e, am, v, params);
+  REQUIRE(R_ldlt.real() == Approx(R_lu.real()));
+  REQUIRE(R_ldlt.imag() == Approx(R_lu.imag()));
+}
+
+TEST_CASE("Coupled-channel R-matrix") {
+  // n + 40Ca ground state, and excited states at 3.737 and 3.904 MeV
+  const auto channels = std::vector<Channel>{
+      Channel(0., 12., constants::n_mass_amu, 0, 2, 40., 20),
+      Channel(3.737, 12., constants::n_mass_amu, 0, 2, 40., 20),
+      Channel(3.904, 12., constants::n_mass_amu, 0, 2, 40., 20)};
+  const auto am = std::vector<Channel::FermionSpinOrbitCoupling>{
+      Channel::FermionSpinOrbitCoupling(2, 0),
+      Channel::FermionSpinOrbitCoupling(6, 3),
+      Channel::FermionSpinOrbitCoupling(4, 2)};
+  const auto erg = 10.;
+  const auto n = size_t{30};
+  const auto solver = RMatrixKernel(n, 3);
+
+  auto params = Params(std::array<size_t, 1>{18});
+  params.fill(0.);
+  params(0) = -50.;
+  params(1) = 4.1;
+  params(2) = 0.6;
+  const auto v = OMP<Params>(0.);
+  const auto potentials = std::vector<const Potential<Params> *>{&v, &v, &v};
+  const auto all_params = std::vector<Params>{params, params, params};
+
+  auto form_params = Params(std::array<size_t, 1>{3});
+  form_params(0) = -50.;
+  form_params(1) = 4.1;
+  form_params(2) = 0.6;
+  const auto form_factor = DerivWoodsSaxon<Params>{};
+  auto strengths = xt::xtensor<real, 2>({3, 3});
+  strengths.fill(0.);
+
+  SECTION("uncoupled channels reduce to single-channel solves") {
+    const auto coupling =
+        ChannelCoupling<Params>{form_factor, form_params, strengths};
+    const auto m =
+        solver.coupled_matrices(channels, erg, am, potentials, all_params,
+                                coupling);
+    for (size_t c = 0; c < 3; ++c) {
+      const auto e = channels[c].set_erg_cms(erg);
+      const auto single = RMatrixKernel(n, 1).matrices(channels[c], e, am[c],
+                                                       v, params);
+      REQUIRE(m.S(c, c).real() == Approx(single.S.real()));
+      REQUIRE(m.S(c, c).imag() == Approx(single.S.imag()));
+      for (size_t cp = 0; cp < 3; ++cp)
+        if (cp != c)
+          REQUIRE(std::abs(m.S(c, cp)) == Approx(0.).margin(1e-12));
+    }
+  }
+
+  SECTION("coupled channels") {
+    // without a (1, 2) coupling, channels 1 and 2 only couple through channel
+    // 0, so eliminating channel 0 fills in an absent (1, 2) block; with one,
+    // it fills in a block held as a diagonal
+    strengths(0, 1) = strengths(1, 0) = 0.7;
+    strengths(0, 2) = strengths(2, 0) = 0.4;
+    for (const real s12 : {0., 0.3}) {
+      strengths(1, 2) = strengths(2, 1) = s12;
+      const auto coupling =
+          ChannelCoupling<Params>{form_factor, form_params, strengths};
+      const auto m =
+          solver.coupled_matrices(channels, erg, am, potentials, all_params,
+                                  coupling);
+
+      // dense reference assembly of the full mesh matrix [MeV]
+      const auto a = channels[0].radius;
+      const auto r = solver.mesh(a);
+      auto C = xt::xtensor<cmpl, 2>({3 * n, 3 * n});
+      C.fill(0.);
+      auto h2m = std::vector<real>(3);
+      for (size_t c = 0; c < 3; ++c) {
+        const auto e = channels[c].set_erg_cms(erg);
+        h2m[c] = e.h2ma * a;
+        const auto D = solver.free_matrix(e.k * a, am[c].l);
+        for (size_t i = 0; i < n; ++i) {
+          for (size_t j = 0; j < n; ++j)
+            C(c * n + i, c * n + j) = h2m[c] / (a * a) * D(i, j);
+          C(c * n + i, c * n + i) += v(r(i), params);
+          for (size_t cp = 0; cp < 3; ++cp)
+            if (cp != c)
+              C(c * n + i, cp * n + i) +=
+                  strengths(c, cp) * form_factor(r(i), form_params);
+        }
+      }
+      const auto f = solver.boundary_values();
+      for (size_t c = 0; c < 3; ++c) {
+        auto b = xt::xtensor<cmpl, 1>(std::array<size_t, 1>{3 * n});
+        b.fill(0.);
+        for (size_t i = 0; i < n; ++i)
+          b(c * n + i) = f(i);
+        const xt::xtensor<cmpl, 1> x = xt::linalg::solve(C, b);
+        for (size_t cp = 0; cp < 3; ++cp) {
+          cmpl G = 0;
+          for (size_t i = 0; i < n; ++i)
+            G += f(i) * x(cp * n + i);
+          const auto R = sqrt(h2m[c] * h2m[cp]) / (a * a) * G;
+          REQUIRE(m.R(cp, c).real() == Approx(R.real()));
+          REQUIRE(m.R(cp, c).imag() == Approx(R.imag()).margin(1e-12));
+        }
+      }
+
+      // real potentials: S is symmetric and unitary
+      for (size_t c = 0; c < 3; ++c) {
+        for (size_t cp = 0; cp < 3; ++cp) {
+          REQUIRE(m.S(c, cp).real() == Approx(m.S(cp, c).real()));
+          REQUIRE(m.S(c, cp).imag() == Approx(m.S(cp, c).imag()));
+          cmpl SdagS = 0;
+          for (size_t k = 0; k < 3; ++k)
+            SdagS += std::conj(m.S(k, c)) * m.S(k, cp);
+          REQUIRE(SdagS.real() == Approx(c == cp ? 1. : 0.).margin(1e-10));
+          REQUIRE(SdagS.imag() == Approx(0.).margin(1e-10));
+        }
+      }
+      REQUIRE(std::abs(m.S(1, 2)) > 0.);
+  }
+  }
+}
+
+TEST_CASE("Non-local mesh assembly") {
+  const auto ch = Channel(0., 12., constants::n_mass_amu, 0, 2, 40., 20);
+  const auto e = ch.set_erg_cms(10.);
+  const auto am = Channel::FermionSpinOrbitCoupling(2, 0);
+  // not a multiple of the tile size
+  const auto solver = RMatrixKernel(37, 1);
+  const auto v = SmearedWell{};
+  auto params = Params(std::array<size_t, 1>{5});
+  params(0) = -40.;
+  params(1) = 4.1;
+  params(2) = 0.6;
+  params(3) = 0.9;
+  params(4) = -5.;
+
+  const auto r = solver.mesh(ch.radius);
+  const auto quadrature = gl::generate_gauss_legendre_quadrature(37);
+  const auto M = solver.nonlocal_matrix(ch.radius, v, params);
+  for (size_t i = 0; i < 37; ++i) {
+    for (size_t j = 0; j < 37; ++j) {
+      const auto ref = ch.radius *
+                       sqrt(quadrature[i].weight * quadrature[j].weight) *
+                       v(r(i), r(j), params);
+      REQUIRE(M(i, j).real() == Approx(ref.real()));
+      REQUIRE(M(i, j).imag() == Approx(ref.imag()));
+    }
+  }
+
+  const auto threaded = solver.matrices(ch, e, am, v, params, 4);
+  const auto serial = solver.matrices(ch, e, am, v, params);
+  REQUIRE(threaded.S.real() == Approx(serial.S.real()).margin(1e-14));
+  REQUIRE(threaded.S.imag() == Approx(serial.S.imag()).margin(1e-14));
+  REQUIRE(std::abs(serial.S) < 1.);
+}
+
+TEST_CASE("Fixed-size solver matches the kernel for local potentials") {
+  const auto ch = Channel(0., 12., constants::n_mass_amu, 0, 2, 40., 20);
+  const auto e = ch.set_erg_cms(10.);
+  constexpr size_t n = 20;
+  const auto solver = RMatrixKernel(n, 1);
+  const auto fixed = LagrangeMeshSolver<n>(ch.radius);
+  const auto params = Params{-48., 4.2, 0.65, -3., 4.2, 0.65, 0.5, 4.4, 0.55,
+                             -6.,  4.4, 0.55, 5.5, 3.9, 0.6,  -0.1, 3.9, 0.6};
+  for (const auto &am : {Channel::FermionSpinOrbitCoupling(2, 0),
+                         Channel::FermionSpinOrbitCoupling(4, 1)}) {
+    const auto v = OMP<Params>(am.l_dot_s());
+    const auto R = solver.rmatrix(ch, e, am, v, params);
+    const auto R_fixed = fixed.rmatrix(ch, e, am, v, params);
+    REQUIRE(R_fixed.real() == Approx(R.real()));
+    REQUIRE(R_fixed.imag() == Approx(R.imag()));
+  }
+
+  const auto ws = CountingWoodsSaxon{};
+  const auto am = Channel::FermionSpinOrbitCoupling(2, 0);
+  const auto ws_params = Params{-48., 4.2, 0.65};
+  const auto R = fixed.rmatrix(ch, e, am, ws, ws_params);
+  REQUIRE(ws.pointwise == 0);
+  REQUIRE(R.real() ==
+          Approx(solver.rmatrix(ch, e, am, ws, ws_params).real()));
+}
+
+TEST_CASE("Perey-Buck non-local potential") {
+  const auto ch = Channel(0., 12., constants::n_mass_amu, 0, 2, 40., 20);
+  const auto e = ch.set_erg_cms(10.);
+  const auto am = Channel::FermionSpinOrbitCoupling(2, 0);
+  constexpr size_t n = 20;
+  const auto solver = RMatrixKernel(n, 1);
+  const auto v = PereyBuck<Params>(
+      std::make_unique<WoodsSaxon<ViewType<Params>>>());
+  // Woods-Saxon U, then a normalized Gaussian of range beta
+  const real beta = 0.85;
+  auto params =
+      Params{-71., 4.1, 0.6, 1. / (std::sqrt(constants::pi) * beta), 0., beta};
+
+  // U((r + rp)/2) H(r - rp)
+  const auto local = WoodsSaxon<Params>{}(2., Params{-71., 4.1, 0.6});
+  const auto smear = Gaussian<Params>{}(-2., Params{params(3), 0., beta});
+  REQUIRE(v(1., 3., params).real() == Approx((local * smear).real()));
+  REQUIRE(v(1., 3., params).real() == Approx(v(3., 1., params).real()));
+
+  const auto r = solver.mesh(ch.radius);
+  const auto quadrature = gl::generate_gauss_legendre_quadrature(n);
+  const auto check_assembly = [&]() {
+    const auto M = solver.nonlocal_matrix(ch.radius, v, params);
+    for (size_t i = 0; i < n; ++i) {
+      for (size_t j = 0; j < n; ++j) {
+        const auto ref = ch.radius *
+                         sqrt(quadrature[i].weight * quadrature[j].weight) *
+                         v(r(i), r(j), params);
+        REQUIRE(M(i, j).real() == Approx(ref.real()).margin(1e-12));
+        REQUIRE(M(i, j).imag() == Approx(ref.imag()).margin(1e-12));
+      }
+    }
+    // the R-matrix from a dense solve of the same matrix, and from the
+    // fixed-size solver
+    auto C = solver.free_matrix(e.k * ch.radius, am.l);
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < n; ++j)
+        C(i, j) += ch.radius / e.h2ma * M(i, j);
+    const auto f = xt::xtensor<cmpl, 1>(solver.boundary_values());
+    const xt::xtensor<cmpl, 1> x = xt::linalg::solve(C, f);
+    cmpl R_dense = 0;
+    for (size_t i = 0; i < n; ++i)
+      R_dense += f(i) * x(i);
+    const auto R = solver.rmatrix(ch, e, am, v, params);
+    REQUIRE(R.real() == Approx(R_dense.real()));
+    REQUIRE(R.imag() == Approx(R_dense.imag()).margin(1e-12));
+    const auto R_fixed =
+        LagrangeMeshSolver<n>(ch.radius).rmatrix(ch, e, am, v, params);
+    REQUIRE(R_fixed.real() == Approx(R_dense.real()));
+    REQUIRE(R_fixed.imag() == Approx(R_dense.imag()).margin(1e-12));
+    return M;
+  };
+
+  SECTION("centered, symmetric") {
+    REQUIRE(v.is_symmetric(params));
+    check_assembly();
+  }
+
+  SECTION("shifted, assembled in full") {
+    params(4) = 0.4;
+    REQUIRE(not v.is_symmetric(params));
+    REQUIRE(v(1., 3., params).real() != Approx(v(3., 1., params).real()));
+    const auto M = check_assembly();
+    REQUIRE(M(3, 7).real() != Approx(M(7, 3).real()));
+  }
+}
+
+TEST_CASE("Forward-mode OMP parameter derivatives") {
+  const auto ch = Channel(0., 12., constants::n_mass_amu, 0, 2, 40., 20);
+  const auto e = ch.set_erg_cms(10.);
+  const auto solver = RMatrixKernel(30, 1);
+  const auto params = Params{-48., 4.2, 0.65, -3., 4.2, 0.65, 0.5, 4.4, 0.55,
+                             -6.,  4.4, 0.55, 5.5, 3.9, 0.6,  -0.1, 3.9, 0.6};
+
+  for (const auto &am : {Channel::FermionSpinOrbitCoupling(4, 1),
+                         Channel::FermionSpinOrbitCoupling(2, 1)}) {
+    const auto v = OMP<Params>(am.l_dot_s());
+    const auto d = solver.derivatives(ch, e, am, params);
+    const auto reference = solver.matrices(ch, e, am, v, params);
+    REQUIRE(d.matrices.R.real() == Approx(reference.R.real()));
+    REQUIRE(d.matrices.S.imag() == Approx(reference.S.imag()));
+
+    for (size_t k = 0; k < 18; ++k) {
+      // central differences; the solve carries round-off of about 1e-13, so
+      // smaller steps lose accuracy
+      const auto h = 1e-4 * std::max(1., fabs(params(k)));
+      auto plus = params;
+      auto minus = params;
+      plus(k) += h;
+      minus(k) -= h;
+      const auto mp = solver.matrices(ch, e, am, v, plus);
+      const auto mm = solver.matrices(ch, e, am, v, minus);
+      const auto dR = (mp.R - mm.R) / (2 * h);
+      const auto dS = (mp.S - mm.S) / (2 * h);
+      REQUIRE(d.dR(k).real() == Approx(dR.real()).margin(5e-8).epsilon(1e-4));
+      REQUIRE(d.dR(k).imag() == Approx(dR.imag()).margin(5e-8).epsilon(1e-4));
+      REQUIRE(d.dS(k).real() == Approx(dS.real()).margin(5e-8).epsilon(1e-4));
+      REQUIRE(d.dS(k).imag() == Approx(dS.imag()).margin(5e-8).epsilon(1e-4));
+    }
+  }
+}
+
+TEST_CASE("Adjoint sensitivities agree with forward mode") {
+  const auto ch = Channel(0., 12., constants::n_mass_amu, 0, 2, 40., 20);
+  const auto e = ch.set_erg_cms(14.);
+  const auto params = Params{-46., 4.3, 0.66, -2., 4.3, 0.66, 0., 4.5, 0.5,
+                             -7.,  4.5, 0.5,  5.8, 3.8, 0.6,  -0.2, 3.8, 0.6};
+
+  for (const auto factorization :
+       {Factorization::symmetric, Factorization::lu}) {
+    const auto solver = RMatrixKernel(30, 1, factorization);
+    for (const auto &am : {Channel::FermionSpinOrbitCoupling(2, 0),
+                           Channel::FermionSpinOrbitCoupling(6, 2)}) {
+      const auto forward = solver.derivatives(ch, e, am, params);
+      const auto adjoint = solver.adjoint_derivatives(ch, e, am, params);
+      REQUIRE(adjoint.matrices.S.real() == Approx(forward.matrices.S.real()));
+      for (size_t k = 0; k < 18; ++k) {
+        REQUIRE(adjoint.dS(k).real() ==
+                Approx(forward.dS(k).real()).margin(1e-12));
+        REQUIRE(adjoint.dS(k).imag() ==
+                Approx(forward.dS(k).imag()).margin(1e-12));
+      }
+
+      // a single parameter of an arbitrary potential: the mesh sensitivities
+      // contracted with dV/dV0 = V / V0
+      const auto v = OMP<Params>(am.l_dot_s());
+      const auto sens = solver.sensitivities(ch, e, am, v, params);
+      const auto r = solver.mesh(ch.radius);
+      auto dV = std::vector<cmpl>(r.size());
+      WoodsSaxon<Params>{}.batch(r.data(), r.size(), Params{1., 4.3, 0.66},
+                                 dV.data());
+      const auto d = sens.derivatives(dV.data(), 1);
+      REQUIRE(d.dS(0).real() == Approx(forward.dS(0).real()).margin(1e-12));
+      REQUIRE(d.dS(0).imag() == Approx(forward.dS(0).imag()).margin(1e-12));
+    }
+  }
+}
+
+TEST_CASE("Point Coulomb potential matches Coulomb asymptotics") {
+  // proton on Z = 20; with no nuclear terms and a point charge the potential
+  // is exactly the one of the asymptotic Coulomb functions, so the nuclear
+  // S-matrix is 1
+  const int Zt = 20;
+  const auto ch = Channel(0., 15., constants::p_mass_amu, 1, 2, 40., Zt);
+  const auto e = ch.set_erg_cms(12.);
+  REQUIRE(e.sommerfield_param > 0.);
+  const auto solver = RMatrixKernel(40, 1);
+
+  auto params = Params(std::array<size_t, 1>{20});
+  params.fill(0.);
+  params(18) = Zt * constants::e_sqr;
+  for (const auto &am : {Channel::FermionSpinOrbitCoupling(2, 0),
+                         Channel::FermionSpinOrbitCoupling(6, 2)}) {
+    const auto v = ProtonOMP<Params>(am.l_dot_s());
+    const auto S = solver.matrices(ch, e, am, v, params).S;
+    REQUIRE(S.real() == Approx(1.).margin(1e-6));
+    REQUIRE(S.imag() == Approx(0.).margin(1e-6));
+  }
+
+  // a uniformly charged sphere only scatters in low partial waves
+  params(19) = 4.;
+  const auto waves = solver.partial_waves(ch, e, params, 8);
+  const auto &up = waves[static_cast<int>(Polarization::up)];
+  REQUIRE(std::abs(up[0].S) == Approx(1.));
+  REQUIRE(std::abs(up[0].S - 1.) > 1e-3);
+  REQUIRE(std::abs(up[7].S - 1.) < 1e-4);
+}
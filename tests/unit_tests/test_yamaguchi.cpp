@@ -1,4 +1,5 @@
 #include "potential/potential.hpp"
+#include "solver/lagrange_mesh_solver.hpp"
 #include "solver/solver.hpp"
 #include "util/constants.hpp"
 
@@ -11,73 +12,145 @@ using constants::c;
 using constants::hbar;
 
 using Catch::Approx;
-/*
 using Solver = LagrangeMeshSolver<20>;
-
+using Params = xt::xtensor<real, 1>;
+
+namespace {
+/// @returns the energetics of the Table 16 benchmark, which uses
+/// non-relativistic kinematics with hbar^2/(2 mu) = f
+Channel::Energetics benchmark_energetics(const Channel &ch, real erg) {
+  const auto f = Yamaguchi<Params>::dn_triplet_params()(2);
+  auto e = ch.set_erg_cms(erg);
+  e.k = sqrt(erg / f);
+  e.h2ma = f / ch.radius;
+  return e;
+}
+} // namespace
 
 TEST_CASE("Yamaguchi analytic s-wave phase shift") {
- // test of R-Matrix solver against analytic potential
- // see Table 16 of
- // Baye, Daniel. "The Lagrange-mesh method." Physics reports 565 (2015): 1-107.
+  // test of R-Matrix solver against analytic potential
+  // see Table 16 of
+  // Baye, Daniel. "The Lagrange-mesh method." Physics reports 565 (2015): 1-107.
 
   // potential
-  const auto p = Yamaguchi();
+  const auto p = Yamaguchi<Params>();
+  const auto params = Yamaguchi<Params>::dn_triplet_params();
 
-  const auto ch  = Channel(0., 15, constants::n_mass_amu, 0, 2,
-                           constants::p_mass_amu, 1);
+  const auto ch =
+      Channel(0., 15, constants::n_mass_amu, 0, 2, constants::p_mass_amu, 1);
   // solver
   Solver solver(ch.radius);
 
-  // S-Wave, 0+
-  const auto am   = Channel::AngularMomentum( 2);
+  // S-Wave, 1/2+
+  const auto am = Channel::FermionSpinOrbitCoupling(2, 0);
   SECTION("0.1MeV") {
-    const auto e  = ch.set_erg_cms(0.1);
-    const auto k  = e.k;
+    const auto e = benchmark_energetics(ch, 0.1);
+    const auto k = e.k;
 
-    const auto swave_k = p.analytic_swave_kmatrix(k);
+    const auto swave_k = p.analytic_swave_kmatrix(k, params);
 
     REQUIRE(e.erg_cms == 0.1);
     REQUIRE(am.l == 0);
-    REQUIRE(k == Approx(sqrt(e.erg_cms/41.472)));
-    REQUIRE(e.reduced_mass == Approx(hbar*hbar*c*c/(2*41.472)).epsilon(0.01));
+    REQUIRE(k == Approx(sqrt(e.erg_cms / 41.472)));
+    REQUIRE(e.reduced_mass ==
+            Approx(hbar * hbar * c * c / (2 * 41.472)).epsilon(0.01));
 
-    const auto delta = solver.matrices(ch, e, am, p).phase_shift;
-    const auto K     = solver.matrices(ch, e, am, p).K();
+    const auto delta = solver.matrices(ch, e, am, p, params).phase_shift;
+    const auto K = solver.matrices(ch, e, am, p, params).K();
 
-    REQUIRE( delta.real() == Approx(-0.263137 ) );
-    REQUIRE( delta.imag() + 1.0 == Approx(1.0) );
-    REQUIRE( K.real() == Approx(swave_k) );
-    REQUIRE( K.imag() == Approx(0.) );
+    REQUIRE(delta.real() == Approx(-0.2631727735));
+    REQUIRE(delta.imag() + 1.0 == Approx(1.0));
+    REQUIRE(K.real() == Approx(swave_k));
+    REQUIRE(K.imag() == Approx(0.).margin(1e-10));
   }
 
   SECTION("1.89MeV") {
-    const auto e  = ch.set_erg_cms(1.89);
-    const auto k  = e.k;
-
-    const auto swave_k = p.analytic_swave_kmatrix(k);
+    const auto e = benchmark_energetics(ch, 1.89);
+    const auto swave_k = p.analytic_swave_kmatrix(e.k, params);
 
     REQUIRE(am.l == 0);
-    REQUIRE( solver.matrices(ch, e, am, p).K().real() == Approx(swave_k) );
+    REQUIRE(solver.matrices(ch, e, am, p, params).K().real() ==
+            Approx(swave_k));
   }
 
   SECTION("10MeV") {
-    const auto e  = ch.set_erg_cms(10.0);
-    const auto k  = e.k;
+    const auto e = benchmark_energetics(ch, 10.0);
+    const auto k = e.k;
 
-    const auto swave_k = p.analytic_swave_kmatrix(k);
+    const auto swave_k = p.analytic_swave_kmatrix(k, params);
 
     REQUIRE(e.erg_cms == 10.0);
     REQUIRE(am.l == 0);
-    REQUIRE(k == Approx(sqrt(e.erg_cms/41.472)));
-    REQUIRE(e.reduced_mass == Approx(hbar*hbar*c*c/(2*41.472)).epsilon(0.01));
-
-    const auto delta = solver.matrices(ch, e, am, p).phase_shift;
-    const auto K     = solver.matrices(ch, e, am, p).K();
-    REQUIRE( delta.real() == Approx(1.4946050256) );
-    REQUIRE( delta.imag() + 1.0 == Approx(1.0) );
-    REQUIRE( K.real() == Approx(swave_k) );
-    REQUIRE( K.imag() == Approx(0.) );
+    REQUIRE(k == Approx(sqrt(e.erg_cms / 41.472)));
+    REQUIRE(e.reduced_mass ==
+            Approx(hbar * hbar * c * c / (2 * 41.472)).epsilon(0.01));
+
+    const auto delta = solver.matrices(ch, e, am, p, params).phase_shift;
+    const auto K = solver.matrices(ch, e, am, p, params).K();
+    REQUIRE(delta.real() == Approx(1.4946050256));
+    REQUIRE(delta.imag() + 1.0 == Approx(1.0));
+    REQUIRE(K.real() == Approx(swave_k));
+    REQUIRE(K.imag() == Approx(0.).margin(1e-10));
+  }
+
+  SECTION("agrees with the runtime-sized kernel") {
+    const auto e = ch.set_erg_cms(1.89);
+    const auto R = RMatrixKernel(20, 1).rmatrix(ch, e, am, p, params);
+    REQUIRE(solver.rmatrix(ch, e, am, p, params).real() == Approx(R.real()));
   }
 }
 
-*/
+TEST_CASE("Yamaguchi s-wave phase shift with low-rank update") {
+  // see Table 16 of
+  // Baye, Daniel. "The Lagrange-mesh method." Physics reports 565 (2015): 1-107.
+  const auto p = Yamaguchi<Params>();
+  const auto ch =
+      Channel(0., 15, constants::n_mass_amu, 0, 2, constants::p_mass_amu, 1);
+  const auto solver = RMatrixKernel(20, 1);
+  const auto am = Channel::FermionSpinOrbitCoupling(2, 0);
+
+  SECTION("0.1MeV") {
+    const auto e = benchmark_energetics(ch, 0.1);
+    const auto params = Yamaguchi<Params>::dn_triplet_params();
+    const auto delta = solver.matrices(ch, e, am, p, params).phase_shift;
+    REQUIRE(delta.real() == Approx(-0.2631727735));
+    REQUIRE(delta.imag() + 1.0 == Approx(1.0));
+  }
+
+  SECTION("10MeV") {
+    const auto e = benchmark_energetics(ch, 10.);
+    const auto params = Yamaguchi<Params>::dn_triplet_params();
+    const auto delta = solver.matrices(ch, e, am, p, params).phase_shift;
+    REQUIRE(delta.real() == Approx(1.4946050256));
+  }
+
+  SECTION("analytic K-matrix") {
+    for (const auto erg : {0.1, 1.89, 10.}) {
+      const auto e = ch.set_erg_cms(erg);
+      // strength consistent with the kinematics of the channel
+      auto params = Yamaguchi<Params>::dn_triplet_params();
+      params(2) = e.h2ma * ch.radius;
+      const auto K = solver.matrices(ch, e, am, p, params).K();
+      REQUIRE(K.real() == Approx(p.analytic_swave_kmatrix(e.k, params)));
+      REQUIRE(K.imag() == Approx(0.).margin(1e-10));
+    }
+  }
+
+  SECTION("agrees with dense non-local assembly") {
+    const auto e = ch.set_erg_cms(1.89);
+    const auto params = Yamaguchi<Params>::dn_triplet_params();
+    const auto R_separable = solver.rmatrix(ch, e, am, p, params);
+    const auto V = solver.nonlocal_matrix(ch.radius, p, params);
+    auto C = solver.free_matrix(e.k * ch.radius, am.l);
+    const auto n = static_cast<size_t>(solver.size());
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < n; ++j)
+        C(i, j) += ch.radius / e.h2ma * V(i, j);
+    const auto f = xt::xtensor<cmpl, 1>(solver.boundary_values());
+    const xt::xtensor<cmpl, 1> x = xt::linalg::solve(C, f);
+    cmpl R_dense = 0;
+    for (size_t i = 0; i < n; ++i)
+      R_dense += f(i) * x(i);
+    REQUIRE(R_separable.real() == Approx(R_dense.real()));
+  }
+}
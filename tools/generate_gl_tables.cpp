@@ -0,0 +1,77 @@
+/// Build-time generator of extern/gl_tables.hpp: the Gauss-Legendre rules of
+/// the orders given on the command line, written as explicit specializations
+/// of gl::FixedRule with hexadecimal floating literals, so the tables are
+/// bit-for-bit the output of generate_gauss_legendre_quadrature
+#include "extern/legendre_rule.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string hexfloat(double x) {
+  char buffer[64];
+  std::snprintf(buffer, sizeof(buffer), "%a", x);
+  return buffer;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    std::fprintf(stderr, "usage: %s <output header> <order>...\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  auto orders = std::vector<int>{};
+  for (int i = 2; i < argc; ++i) {
+    const auto order = std::atoi(argv[i]);
+    if (order < 1) {
+      std::fprintf(stderr, "invalid order: %s\n", argv[i]);
+      return EXIT_FAILURE;
+    }
+    orders.push_back(order);
+  }
+
+  std::ofstream out(argv[1]);
+  if (not out) {
+    std::fprintf(stderr, "cannot open %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  out << "// Generated by tools/generate_gl_tables.cpp, do not edit\n"
+         "#ifndef GL_TABLES_HEADER\n"
+         "#define GL_TABLES_HEADER\n\n"
+         "#include \"extern/legendre_rule.hpp\"\n\n"
+         "#include <array>\n"
+         "#include <cstddef>\n\n"
+         "namespace gl {\n\n"
+         "template <size_t N> struct FixedRule;\n\n";
+
+  for (const auto order : orders) {
+    const auto rule = gl::generate_gauss_legendre_quadrature(order);
+    out << "template <> struct FixedRule<" << order << "> {\n"
+        << "  static constexpr std::array<zero_crossing, " << order
+        << "> nodes = {{\n";
+    for (const auto &node : rule)
+      out << "      {" << hexfloat(node.abscissa) << ", "
+          << hexfloat(node.weight) << "},\n";
+    out << "  }};\n};\n\n";
+  }
+
+  out << "/// @returns the tabulated rule of a given order, or nullptr if that "
+         "order\n/// is not tabulated\n"
+         "inline const zero_crossing *tabulated_rule(int order) {\n"
+         "  switch (order) {\n";
+  for (const auto order : orders)
+    out << "  case " << order << ":\n    return FixedRule<" << order
+        << ">::nodes.data();\n";
+  out << "  default:\n    return nullptr;\n  }\n}\n\n"
+         "} // namespace gl\n\n"
+         "#endif\n";
+
+  return out ? EXIT_SUCCESS : EXIT_FAILURE;
+}